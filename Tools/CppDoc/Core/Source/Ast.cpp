@@ -21,6 +21,91 @@ CPPDOC_EXPR_LIST(CPPDOC_ACCEPT)
 CPPDOC_STAT_LIST(CPPDOC_ACCEPT)
 #undef CPPDOC_ACCEPT
 
+/***********************************************************************
+ExprTsysList
+***********************************************************************/
+
+const ExprTsysItem& ExprTsysList::Get(vint index)const
+{
+	CHECK_ERROR(0 <= index && index < count, L"ExprTsysList::Get(vint)#Argument index not in range.");
+	return index < InlineCount ? inlineItems[index] : spilledItems[index - InlineCount];
+}
+
+bool ExprTsysList::Contains(const ExprTsysItem& item)const
+{
+	if (count > InlineCount)
+	{
+		return sortedItems.Contains(item);
+	}
+
+	for (vint i = 0; i < count; i++)
+	{
+		if (inlineItems[i] == item) return true;
+	}
+	return false;
+}
+
+vint ExprTsysList::Add(const ExprTsysItem& item)
+{
+	if (count < InlineCount)
+	{
+		inlineItems[count] = item;
+	}
+	else
+	{
+		if (count == InlineCount)
+		{
+			for (vint i = 0; i < InlineCount; i++)
+			{
+				sortedItems.Add(inlineItems[i]);
+			}
+		}
+		spilledItems.Add(item);
+		sortedItems.Add(item);
+	}
+	return count++;
+}
+
+bool ExprTsysList::RemoveAt(vint index)
+{
+	CHECK_ERROR(0 <= index && index < count, L"ExprTsysList::RemoveAt(vint)#Argument index not in range.");
+	if (count > InlineCount)
+	{
+		sortedItems.Remove(Get(index));
+	}
+
+	if (index < InlineCount)
+	{
+		for (vint i = index; i < InlineCount - 1; i++)
+		{
+			inlineItems[i] = inlineItems[i + 1];
+		}
+		if (spilledItems.Count() > 0)
+		{
+			inlineItems[InlineCount - 1] = spilledItems[0];
+			spilledItems.RemoveAt(0);
+		}
+	}
+	else
+	{
+		spilledItems.RemoveAt(index - InlineCount);
+	}
+
+	count--;
+	if (count == InlineCount)
+	{
+		sortedItems.Clear();
+	}
+	return true;
+}
+
+void ExprTsysList::Clear()
+{
+	spilledItems.Clear();
+	sortedItems.Clear();
+	count = 0;
+}
+
 /***********************************************************************
 Resolving
 ***********************************************************************/
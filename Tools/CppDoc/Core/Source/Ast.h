@@ -57,10 +57,18 @@ public:
 	virtual void			Accept(IDeclarationVisitor* visitor) = 0;
 };
 
+class TypeTsysCache;
+class ExprTsysCache;
+
 class ITypeVisitor;
 class Type : public Object
 {
 public:
+	vint					resolvedHash = 0;			// cached by HashResolvedType
+	bool					resolvedHashCached = false;
+	bool					resolvedHashComparable = true;	// false if DeclType or expression arguments are inside
+	Ptr<TypeTsysCache>		tsysCache;					// cached by TypeToTsys
+
 	virtual void			Accept(ITypeVisitor* visitor) = 0;
 };
 
@@ -68,6 +76,8 @@ class IExprVisitor;
 class Expr : public Object
 {
 public:
+	Ptr<ExprTsysCache>		tsysCache;					// cached by ExprToTsys
+
 	virtual void			Accept(IExprVisitor* visitor) = 0;
 };
 
@@ -122,9 +132,82 @@ struct NotConvertableException {};
 struct IllegalExprException {};
 
 using TypeTsysList = List<ITsys*>;
-using ExprTsysList = List<ExprTsysItem>;
+
+// A set of ExprTsysItem in adding order
+//   the first few items are stored inline, a sorted index is created for larger sets
+class ExprTsysList : public Object, public virtual IEnumerable<ExprTsysItem>
+{
+protected:
+	class Enumerator : public Object, public virtual IEnumerator<ExprTsysItem>
+	{
+	protected:
+		const ExprTsysList*		list;
+		vint					index;
+
+	public:
+		Enumerator(const ExprTsysList* _list, vint _index = -1) :list(_list), index(_index) {}
+
+		IEnumerator<ExprTsysItem>*	Clone()const override { return new Enumerator(list, index); }
+		const ExprTsysItem&		Current()const override { return list->Get(index); }
+		vint					Index()const override { return index; }
+		bool					Next()override { index++; return index >= 0 && index < list->Count(); }
+		void					Reset()override { index = -1; }
+	};
+
+	static const vint			InlineCount = 4;
+
+	ExprTsysItem				inlineItems[InlineCount];	// the first InlineCount items
+	List<ExprTsysItem>			spilledItems;				// items after the first InlineCount ones
+	SortedList<ExprTsysItem>	sortedItems;				// all items, only when there are more than InlineCount items
+	vint						count = 0;
+
+public:
+	IEnumerator<ExprTsysItem>*	CreateEnumerator()const override { return new Enumerator(this); }
+	vint						Count()const { return count; }
+	const ExprTsysItem&			Get(vint index)const;
+	const ExprTsysItem&			operator[](vint index)const { return Get(index); }
+	bool						Contains(const ExprTsysItem& item)const;
+	vint						Add(const ExprTsysItem& item);
+	bool						RemoveAt(vint index);
+	void						Clear();
+};
+
+class TypeTsysCache : public Object
+{
+public:
+	struct Entry
+	{
+		Symbol*					context;
+		TsysCallingConvention	cc;
+		bool					memberOf;
+		vint					generation;			// generation of the unit when the entry is created, it changes with the allocator or the recorder
+		TypeTsysList			types;
+	};
+
+	List<Ptr<Entry>>		entries;
+};
+
+class ExprTsysCache : public Object
+{
+public:
+	struct Entry
+	{
+		Symbol*					context;
+		vint					generation;			// generation of the unit when the entry is created, it changes with the allocator or the recorder
+		ExprTsysList			types;
+	};
+
+	List<Ptr<Entry>>		entries;
+};
+
+struct ExprTsysCacheStatistics
+{
+	vint					hits = 0;
+	vint					misses = 0;
+};
 
 extern bool					IsSameResolvedType(Ptr<Type> t1, Ptr<Type> t2);
+extern vint					HashResolvedType(Ptr<Type> t);
 extern void					TypeToTsys(ParsingArguments& pa, Ptr<Type> t, TypeTsysList& tsys, TsysCallingConvention cc = TsysCallingConvention::None, bool memberOf = false);
 extern void					ExprToTsys(ParsingArguments& pa, Ptr<Expr> e, ExprTsysList& tsys);
 
@@ -130,7 +130,7 @@ public:
 		{
 			if (auto decl = symbol->parent->decls[0].Cast<ClassDeclaration>())
 			{
-				classScope = pa.tsys->DeclOf(symbol->parent);
+				classScope = pa.unit->tsys->DeclOf(symbol->parent);
 			}
 		}
 
@@ -242,7 +242,7 @@ public:
 				}
 				else if (auto enumItemDecl = decl.Cast<EnumItemDeclaration>())
 				{
-					auto tsys = pa.tsys->DeclOf(enumItemDecl->symbol->parent);
+					auto tsys = pa.unit->tsys->DeclOf(enumItemDecl->symbol->parent);
 					AddInternal(result, { symbol,ExprTsysType::PRValue,tsys });
 				}
 				else if (auto funcDecl = decl.Cast<ForwardFunctionDeclaration>())
@@ -439,58 +439,70 @@ public:
 	}
 
 	/***********************************************************************
-	VisitOverloadedFunction: Select good candidates from overloaded functions
+	GetFunctionArity: Get the number of parameters of a function symbol
 	***********************************************************************/
 
-	static void VisitOverloadedFunction(ParsingArguments& pa, ExprTsysList& funcTypes, List<Ptr<ExprTsysList>>& argTypesList, ExprTsysList& result)
+	static const SymbolFunctionArity& GetFunctionArity(Symbol* symbol)
 	{
-		Array<vint> funcDPs(funcTypes.Count());
-		for (vint i = 0; i < funcTypes.Count(); i++)
+		auto& arity = symbol->functionArity;
+		if (!arity.cached)
 		{
-			auto symbol = funcTypes[i].symbol;
+			arity.cached = true;
 			if (symbol->decls.Count() == 1)
 			{
 				if (auto decl = symbol->decls[0].Cast<ForwardFunctionDeclaration>())
 				{
 					if (auto type = GetTypeWithoutMemberAndCC(decl->type).Cast<FunctionType>())
 					{
-						for (vint j = 0; j < type->parameters.Count(); j++)
+						arity.isFunction = true;
+						arity.maxParameterCount = type->parameters.Count();
+						arity.minParameterCount = arity.maxParameterCount;
+						arity.ellipsis = type->ellipsis;
+						for (vint i = 0; i < type->parameters.Count(); i++)
 						{
-							if (type->parameters[j]->initializer)
+							if (type->parameters[i]->initializer)
 							{
-								funcDPs[i] = type->parameters.Count() - j;
-								goto EXAMINE_NEXT_FUNCTION;
+								arity.minParameterCount = i;
+								break;
 							}
 						}
-						funcDPs[i] = 0;
-					EXAMINE_NEXT_FUNCTION:;
 					}
 				}
 			}
 		}
+		return arity;
+	}
 
+	/***********************************************************************
+	SelectOverloadedFunction: Select good candidates from overloaded functions
+	***********************************************************************/
+
+	static void SelectOverloadedFunction(ParsingArguments& pa, ExprTsysList& funcTypes, List<Ptr<ExprTsysList>>& argTypesList, List<ITsys*>& selected, bool& cacheable)
+	{
+		vint argCount = argTypesList.Count();
 		ExprTsysList validFuncTypes;
 		for (vint i = 0; i < funcTypes.Count(); i++)
 		{
 			auto funcType = funcTypes[i];
 
-			vint funcParamCount = funcType.tsys->GetParamCount();
-			vint missParamCount = funcParamCount - argTypesList.Count();
-			if (missParamCount > 0)
+			vint minParamCount = 0, maxParamCount = 0;
+			bool ellipsis = false;
+			if (funcType.symbol && GetFunctionArity(funcType.symbol).isFunction)
 			{
-				if (missParamCount > funcDPs[i])
-				{
-					continue;
-				}
+				auto& arity = funcType.symbol->functionArity;
+				minParamCount = arity.minParameterCount;
+				maxParamCount = arity.maxParameterCount;
+				ellipsis = arity.ellipsis;
 			}
-			else if (missParamCount < 0)
+			else
 			{
-				if (!funcType.tsys->GetFunc().ellipsis)
-				{
-					continue;
-				}
+				maxParamCount = funcType.tsys->GetParamCount();
+				minParamCount = maxParamCount;
+				ellipsis = funcType.tsys->GetFunc().ellipsis;
 			}
 
+			if (argCount < minParamCount) continue;
+			if (argCount > maxParamCount && !ellipsis) continue;
 			validFuncTypes.Add(funcType);
 		}
 
@@ -521,7 +533,7 @@ public:
 				auto bestChoice = TsysConv::Illegal;
 				for (vint k = 0; k < argTypes.Count(); k++)
 				{
-					auto choice = TestConvert(pa, paramType, argTypes[k]);
+					auto choice = TestConvert(pa, paramType, argTypes[k], cacheable);
 					if ((vint)bestChoice > (vint)choice) bestChoice = choice;
 				}
 				funcChoices[j] = bestChoice;
@@ -546,9 +558,57 @@ public:
 		{
 			if (selectedIndices[i])
 			{
-				AddTemp(result, validFuncTypes[i].tsys->GetElement());
+				selected.Add(validFuncTypes[i].tsys->GetElement());
+			}
+		}
+	}
+
+	/***********************************************************************
+	VisitOverloadedFunction: Select good candidates from overloaded functions with cache
+	***********************************************************************/
+
+	static void AppendSignature(List<vint>& signature, ExprTsysList& items)
+	{
+		signature.Add(items.Count());
+		for (vint i = 0; i < items.Count(); i++)
+		{
+			auto& item = items[i];
+			signature.Add((vint)item.symbol);
+			signature.Add((vint)item.type);
+			signature.Add(item.tsys->GetId());
+		}
+	}
+
+	static void VisitOverloadedFunction(ParsingArguments& pa, ExprTsysList& funcTypes, List<Ptr<ExprTsysList>>& argTypesList, ExprTsysList& result)
+	{
+		// the same candidates called with the same arguments always select the same functions
+		Array<vint> signature;
+		{
+			List<vint> items;
+			AppendSignature(items, funcTypes);
+			for (vint i = 0; i < argTypesList.Count(); i++)
+			{
+				AppendSignature(items, *argTypesList[i].Obj());
+			}
+			CopyFrom(signature, items);
+		}
+
+		List<ITsys*> selected;
+		vint generation = pa.unit->GetGeneration();
+		if (!pa.unit->tsys->GetCachedOverload(signature, generation, selected))
+		{
+			bool cacheable = true;
+			SelectOverloadedFunction(pa, funcTypes, argTypesList, selected, cacheable);
+			if (cacheable)
+			{
+				pa.unit->tsys->SetCachedOverload(signature, generation, selected);
 			}
 		}
+
+		for (vint i = 0; i < selected.Count(); i++)
+		{
+			AddTemp(result, selected[i]);
+		}
 	}
 
 	/***********************************************************************
@@ -567,6 +627,43 @@ public:
 		AddInternal(result, fieldResult);
 	}
 
+	/***********************************************************************
+	GetOperatorCandidates: Find overloaded operators related to a type
+	***********************************************************************/
+
+	static Ptr<OperatorCandidateCache::Candidates> GetOperatorCandidates(ParsingArguments& pa, Symbol* decl, CppName& opName)
+	{
+		if (!decl->operatorCandidateCache)
+		{
+			decl->operatorCandidateCache = MakePtr<OperatorCandidateCache>();
+		}
+
+		auto& cache = decl->operatorCandidateCache->candidates;
+		vint generation = pa.unit->GetGeneration();
+		vint index = cache.Keys().IndexOf(opName.name);
+		if (index != -1)
+		{
+			auto candidates = cache.Values()[index];
+			if (candidates->generation == generation)
+			{
+				return candidates;
+			}
+		}
+
+		auto candidates = MakePtr<OperatorCandidateCache::Candidates>();
+		candidates->generation = generation;
+		{
+			ParsingArguments newPa(pa, decl);
+			candidates->methods = ResolveSymbol(newPa, opName, SearchPolicy::ChildSymbol);
+		}
+		{
+			ParsingArguments newPa(pa, decl->parent);
+			candidates->funcs = ResolveSymbol(newPa, opName, SearchPolicy::ChildSymbol);
+		}
+		cache.Set(opName.name, candidates);
+		return candidates;
+	}
+
 	/***********************************************************************
 	Expressions
 	***********************************************************************/
@@ -604,7 +701,7 @@ public:
 						reading++;
 					}
 
-					AddTemp(result, pa.tsys->Zero());
+					AddTemp(result, pa.unit->tsys->Zero());
 					return;
 				}
 			NOT_ZERO:
@@ -612,7 +709,7 @@ public:
 				wchar_t _2 = token.reading[token.length - 1];
 				bool u = _1 == L'u' || _1 == L'U' || _2 == L'u' || _2 == L'U';
 				bool l = _1 == L'l' || _1 == L'L' || _2 == L'l' || _2 == L'L';
-				AddTemp(result, pa.tsys->PrimitiveOf({ (u ? TsysPrimitiveType::UInt : TsysPrimitiveType::SInt),{l ? TsysBytes::_8 : TsysBytes::_4} }));
+				AddTemp(result, pa.unit->tsys->PrimitiveOf({ (u ? TsysPrimitiveType::UInt : TsysPrimitiveType::SInt),{l ? TsysBytes::_8 : TsysBytes::_4} }));
 			}
 			return;
 		case CppTokens::FLOAT:
@@ -621,11 +718,11 @@ public:
 				wchar_t _1 = token.reading[token.length - 1];
 				if (_1 == L'f' || _1 == L'F')
 				{
-					AddTemp(result, pa.tsys->PrimitiveOf({ TsysPrimitiveType::Float, TsysBytes::_4 }));
+					AddTemp(result, pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Float, TsysBytes::_4 }));
 				}
 				else
 				{
-					AddTemp(result, pa.tsys->PrimitiveOf({ TsysPrimitiveType::Float, TsysBytes::_8 }));
+					AddTemp(result, pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Float, TsysBytes::_8 }));
 				}
 			}
 			return;
@@ -636,25 +733,25 @@ public:
 				auto reading = self->tokens[0].reading;
 				if (reading[0] == L'\"' || reading[0]==L'\'')
 				{
-					tsysChar = pa.tsys->PrimitiveOf({ TsysPrimitiveType::SChar,TsysBytes::_1 });
+					tsysChar = pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SChar,TsysBytes::_1 });
 				}
 				else if (reading[0] == L'L')
 				{
-					tsysChar = pa.tsys->PrimitiveOf({ TsysPrimitiveType::UWChar,TsysBytes::_2 });
+					tsysChar = pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UWChar,TsysBytes::_2 });
 				}
 				else if (reading[0] == L'U')
 				{
-					tsysChar = pa.tsys->PrimitiveOf({ TsysPrimitiveType::UChar,TsysBytes::_4 });
+					tsysChar = pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UChar,TsysBytes::_4 });
 				}
 				else if (reading[0] == L'u')
 				{
 					if (reading[1] == L'8')
 					{
-						tsysChar = pa.tsys->PrimitiveOf({ TsysPrimitiveType::SChar,TsysBytes::_1 });
+						tsysChar = pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SChar,TsysBytes::_1 });
 					}
 					else
 					{
-						tsysChar = pa.tsys->PrimitiveOf({ TsysPrimitiveType::UChar,TsysBytes::_2 });
+						tsysChar = pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UChar,TsysBytes::_2 });
 					}
 				}
 
@@ -675,7 +772,7 @@ public:
 			return;
 		case CppTokens::EXPR_TRUE:
 		case CppTokens::EXPR_FALSE:
-			AddTemp(result, pa.tsys->PrimitiveOf({ TsysPrimitiveType::Bool,TsysBytes::_1 }));
+			AddTemp(result, pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Bool,TsysBytes::_1 }));
 			return;
 		}
 		throw IllegalExprException();
@@ -688,7 +785,7 @@ public:
 
 	void Visit(NullptrExpr* self)override
 	{
-		AddTemp(result, pa.tsys->Nullptr());
+		AddTemp(result, pa.unit->tsys->Nullptr());
 	}
 
 	void Visit(ParenthesisExpr* self)override
@@ -734,7 +831,7 @@ public:
 			ExprToTsys(pa, self->expr, types);
 		}
 
-		auto global = pa.root.Obj();
+		auto global = pa.unit->root.Obj();
 		vint index = global->children.Keys().IndexOf(L"std");
 		if (index == -1) return;
 		auto& stds = global->children.GetByIndex(index);
@@ -750,7 +847,7 @@ public:
 			{
 				if (ti->decls[0].Cast<ClassDeclaration>())
 				{
-					AddInternal(result, { nullptr,ExprTsysType::LValue,pa.tsys->DeclOf(ti.Obj()) });
+					AddInternal(result, { nullptr,ExprTsysType::LValue,pa.unit->tsys->DeclOf(ti.Obj()) });
 					return;
 				}
 			}
@@ -770,7 +867,7 @@ public:
 			ExprToTsys(pa, self->expr, types);
 		}
 
-		AddTemp(result, pa.tsys->Size());
+		AddTemp(result, pa.unit->tsys->Size());
 	}
 
 	void Visit(ThrowExpr* self)override
@@ -781,7 +878,7 @@ public:
 			ExprToTsys(pa, self->expr, types);
 		}
 
-		AddTemp(result, pa.tsys->PrimitiveOf({ TsysPrimitiveType::Void,TsysBytes::_1 }));
+		AddTemp(result, pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Void,TsysBytes::_1 }));
 	}
 
 	void Visit(DeleteExpr* self)override
@@ -791,7 +888,7 @@ public:
 			ExprToTsys(pa, self->expr, types);
 		}
 
-		AddTemp(result, pa.tsys->PrimitiveOf({ TsysPrimitiveType::Void,TsysBytes::_1 }));
+		AddTemp(result, pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Void,TsysBytes::_1 }));
 	}
 
 	void Visit(IdExpr* self)override
@@ -866,15 +963,15 @@ public:
 		}
 
 		self->resolving = totalRar.values;
-		if (pa.recorder)
+		if (pa.unit->recorder)
 		{
 			if (totalRar.values)
 			{
-				pa.recorder->Index(self->name, totalRar.values);
+				pa.unit->recorder->Index(self->name, totalRar.values);
 			}
 			if (totalRar.types)
 			{
-				pa.recorder->ExpectValueButType(self->name, totalRar.types);
+				pa.unit->recorder->ExpectValueButType(self->name, totalRar.types);
 			}
 		}
 	}
@@ -1023,7 +1120,7 @@ public:
 			ExprTsysList types;
 			ExprToTsys(pa, self->arguments[i], types);
 		}
-		AddTemp(result, pa.tsys->PrimitiveOf({ TsysPrimitiveType::Void,TsysBytes::_1 }));
+		AddTemp(result, pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Void,TsysBytes::_1 }));
 	}
 
 	void Visit(PostfixUnaryExpr* self)override
@@ -1039,24 +1136,16 @@ public:
 
 			if (entity->GetType() == TsysType::Decl)
 			{
+				CppName opName = self->opName;
+				opName.name = L"operator " + opName.name;
+
 				ResolveSymbolResult opMethods, opFuncs;
 				{
-					CppName opName = self->opName;
-					opName.name = L"operator " + opName.name;
-					ParsingArguments newPa(pa, entity->GetDecl());
-					opMethods = ResolveSymbol(newPa, opName, SearchPolicy::ChildSymbol, opMethods);
-				}
-				{
-					CppName opName = self->opName;
-					opName.name = L"operator " + opName.name;
-					ParsingArguments newPa(pa, entity->GetDecl()->parent);
-					opFuncs = ResolveSymbol(newPa, opName, SearchPolicy::ChildSymbol, opFuncs);
-				}
-				{
-					CppName opName = self->opName;
-					opName.name = L"operator " + opName.name;
-					opFuncs = ResolveSymbol(pa, opName, SearchPolicy::SymbolAccessableInScope, opFuncs);
+					auto candidates = GetOperatorCandidates(pa, entity->GetDecl(), opName);
+					opMethods.Merge(candidates->methods);
+					opFuncs.Merge(candidates->funcs);
 				}
+				opFuncs = ResolveSymbol(pa, opName, SearchPolicy::SymbolAccessableInScope, opFuncs);
 
 				if (opMethods.values)
 				{
@@ -1069,7 +1158,7 @@ public:
 
 					List<Ptr<ExprTsysList>> argTypesList;
 					argTypesList.Add(MakePtr<ExprTsysList>());
-					AddInternal(*argTypesList[0].Obj(), { nullptr,ExprTsysType::PRValue,pa.tsys->Int() });
+					AddInternal(*argTypesList[0].Obj(), { nullptr,ExprTsysType::PRValue,pa.unit->tsys->Int() });
 					FindQualifiedFunctions(pa, {}, TsysRefType::None, opTypes, false);
 					VisitOverloadedFunction(pa, opTypes, argTypesList, result);
 				}
@@ -1086,7 +1175,7 @@ public:
 					argTypesList.Add(MakePtr<ExprTsysList>());
 					argTypesList.Add(MakePtr<ExprTsysList>());
 					AddInternal(*argTypesList[0].Obj(), types[i]);
-					AddInternal(*argTypesList[1].Obj(), { nullptr,ExprTsysType::PRValue,pa.tsys->Int() });
+					AddInternal(*argTypesList[1].Obj(), { nullptr,ExprTsysType::PRValue,pa.unit->tsys->Int() });
 					FindQualifiedFunctions(pa, {}, TsysRefType::None, opTypes, false);
 					VisitOverloadedFunction(pa, opTypes, argTypesList, result);
 				}
@@ -1179,24 +1268,16 @@ public:
 
 			if (entity->GetType() == TsysType::Decl)
 			{
+				CppName opName = self->opName;
+				opName.name = L"operator " + opName.name;
+
 				ResolveSymbolResult opMethods, opFuncs;
 				{
-					CppName opName = self->opName;
-					opName.name = L"operator " + opName.name;
-					ParsingArguments newPa(pa, entity->GetDecl());
-					opMethods = ResolveSymbol(newPa, opName, SearchPolicy::ChildSymbol, opMethods);
-				}
-				{
-					CppName opName = self->opName;
-					opName.name = L"operator " + opName.name;
-					ParsingArguments newPa(pa, entity->GetDecl()->parent);
-					opFuncs = ResolveSymbol(newPa, opName, SearchPolicy::ChildSymbol, opFuncs);
-				}
-				{
-					CppName opName = self->opName;
-					opName.name = L"operator " + opName.name;
-					opFuncs = ResolveSymbol(pa, opName, SearchPolicy::SymbolAccessableInScope, opFuncs);
+					auto candidates = GetOperatorCandidates(pa, entity->GetDecl(), opName);
+					opMethods.Merge(candidates->methods);
+					opFuncs.Merge(candidates->funcs);
 				}
+				opFuncs = ResolveSymbol(pa, opName, SearchPolicy::SymbolAccessableInScope, opFuncs);
 
 				if (opMethods.values)
 				{
@@ -1247,19 +1328,19 @@ public:
 					auto primitive = entity->GetPrimitive();
 					Promote(primitive);
 
-					auto promotedEntity = pa.tsys->PrimitiveOf(primitive);
+					auto promotedEntity = pa.unit->tsys->PrimitiveOf(primitive);
 					if (promotedEntity == entity && primitive.type != TsysPrimitiveType::Float)
 					{
-						AddTemp(result, pa.tsys->PrimitiveOf(primitive)->CVOf(cv));
+						AddTemp(result, pa.unit->tsys->PrimitiveOf(primitive)->CVOf(cv));
 					}
 					else
 					{
-						AddTemp(result, pa.tsys->PrimitiveOf(primitive));
+						AddTemp(result, pa.unit->tsys->PrimitiveOf(primitive));
 					}
 				}
 				break;
 			case CppPrefixUnaryOp::Not:
-				AddTemp(result, pa.tsys->PrimitiveOf({ TsysPrimitiveType::Bool, TsysBytes::_1 }));
+				AddTemp(result, pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Bool, TsysBytes::_1 }));
 				break;
 			case CppPrefixUnaryOp::AddressOf:
 				if (entity->GetType() == TsysType::Ptr && types[i].type == ExprTsysType::PRValue)
@@ -1415,36 +1496,22 @@ public:
 
 				if (leftEntity->GetType() == TsysType::Decl || rightEntity->GetType() == TsysType::Decl)
 				{
+					CppName opName = self->opName;
+					opName.name = L"operator " + opName.name;
+
 					ResolveSymbolResult opMethods, opFuncs;
 					if (leftEntity->GetType() == TsysType::Decl)
 					{
-						{
-							CppName opName = self->opName;
-							opName.name = L"operator " + opName.name;
-							ParsingArguments newPa(pa, leftEntity->GetDecl());
-							opMethods = ResolveSymbol(newPa, opName, SearchPolicy::ChildSymbol, opMethods);
-						}
-						{
-							CppName opName = self->opName;
-							opName.name = L"operator " + opName.name;
-							ParsingArguments newPa(pa, leftEntity->GetDecl()->parent);
-							opFuncs = ResolveSymbol(newPa, opName, SearchPolicy::ChildSymbol, opFuncs);
-						}
+						auto candidates = GetOperatorCandidates(pa, leftEntity->GetDecl(), opName);
+						opMethods.Merge(candidates->methods);
+						opFuncs.Merge(candidates->funcs);
 					}
 					if (rightEntity->GetType() == TsysType::Decl)
 					{
-						{
-							CppName opName = self->opName;
-							opName.name = L"operator " + opName.name;
-							ParsingArguments newPa(pa, rightEntity->GetDecl()->parent);
-							opFuncs = ResolveSymbol(newPa, opName, SearchPolicy::ChildSymbol, opFuncs);
-						}
-					}
-					{
-						CppName opName = self->opName;
-						opName.name = L"operator " + opName.name;
-						opFuncs = ResolveSymbol(pa, opName, SearchPolicy::SymbolAccessableInScope, opFuncs);
+						auto candidates = GetOperatorCandidates(pa, rightEntity->GetDecl(), opName);
+						opFuncs.Merge(candidates->funcs);
 					}
+					opFuncs = ResolveSymbol(pa, opName, SearchPolicy::SymbolAccessableInScope, opFuncs);
 
 					if (opMethods.values)
 					{
@@ -1502,7 +1569,7 @@ public:
 					case CppBinaryOp::NE:
 					case CppBinaryOp::And:
 					case CppBinaryOp::Or:
-						AddTemp(result, pa.tsys->PrimitiveOf({ TsysPrimitiveType::Bool,TsysBytes::_1 }));
+						AddTemp(result, pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Bool,TsysBytes::_1 }));
 						break;
 					case CppBinaryOp::Assign:
 					case CppBinaryOp::MulAssign:
@@ -1526,7 +1593,7 @@ public:
 							{
 								primitive.type = TsysPrimitiveType::UInt;
 							}
-							AddTemp(result, pa.tsys->PrimitiveOf(primitive));
+							AddTemp(result, pa.unit->tsys->PrimitiveOf(primitive));
 						}
 						break;
 					default:
@@ -1534,7 +1601,7 @@ public:
 							auto leftP = leftEntity->GetPrimitive();
 							auto rightP = rightEntity->GetPrimitive();
 							auto primitive = ArithmeticConversion(leftP, rightP);
-							AddTemp(result, pa.tsys->PrimitiveOf(primitive));
+							AddTemp(result, pa.unit->tsys->PrimitiveOf(primitive));
 						}
 					}
 				}
@@ -1548,7 +1615,7 @@ public:
 				}
 				else if (leftPtrArr && rightPtrArr)
 				{
-					AddTemp(result, pa.tsys->IntPtr());
+					AddTemp(result, pa.unit->tsys->IntPtr());
 				}
 			}
 		}
@@ -1638,7 +1705,7 @@ public:
 								auto leftP = leftEntity->GetPrimitive();
 								auto rightP = rightEntity->GetPrimitive();
 								auto primitive = ArithmeticConversion(leftP, rightP);
-								AddTemp(result, pa.tsys->PrimitiveOf(primitive));
+								AddTemp(result, pa.unit->tsys->PrimitiveOf(primitive));
 								continue;
 							}
 
@@ -1665,9 +1732,51 @@ public:
 };
 
 // Resolve expressions to types
+//   results are cached in the expression until any symbol table in the translation unit is changed
 void ExprToTsys(ParsingArguments& pa, Ptr<Expr> e, ExprTsysList& tsys)
 {
 	if (!e) throw IllegalExprException();
+
+	// the visitor merges into existing items, so only an empty list could be filled from the cache
+	if (!pa.unit->exprTsysCacheEnabled || tsys.Count() > 0)
+	{
+		ExprToTsysVisitor visitor(pa, tsys);
+		e->Accept(&visitor);
+		return;
+	}
+
+	vint generation = pa.unit->GetGeneration();
+	if (!e->tsysCache)
+	{
+		e->tsysCache = MakePtr<ExprTsysCache>();
+	}
+
+	auto& entries = e->tsysCache->entries;
+	for (vint i = entries.Count() - 1; i >= 0; i--)
+	{
+		auto entry = entries[i];
+		if (entry->generation != generation)
+		{
+			entries.RemoveAt(i);
+		}
+		else if (entry->context == pa.context)
+		{
+			pa.unit->exprTsysCacheStatistics.hits++;
+			CopyFrom(tsys, entry->types);
+			return;
+		}
+	}
+
+	pa.unit->exprTsysCacheStatistics.misses++;
 	ExprToTsysVisitor visitor(pa, tsys);
 	e->Accept(&visitor);
+
+	if (generation == pa.unit->GetGeneration())
+	{
+		auto entry = MakePtr<ExprTsysCache::Entry>();
+		entry->context = pa.context;
+		entry->generation = generation;
+		CopyFrom(entry->types, tsys);
+		e->tsysCache->entries.Add(entry);
+	}
 }
\ No newline at end of file
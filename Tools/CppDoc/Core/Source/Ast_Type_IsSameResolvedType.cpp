@@ -1,11 +1,14 @@
 #include "Ast.h"
 #include "Ast_Type.h"
 #include "Ast_Decl.h"
+#include "Parser.h"
 
 /***********************************************************************
 IsSameResolvedType
 ***********************************************************************/
 
+vint HashResolvedTypeInternal(Ptr<Type> t, bool& stable, bool& comparable);
+
 class IsSameResolvedTypeVisitor : public Object, public virtual ITypeVisitor
 {
 public:
@@ -167,6 +170,15 @@ bool IsSameResolvedType(Ptr<Type> t1, Ptr<Type> t2)
 {
 	if (t1 && t2)
 	{
+		// types that IsSameResolvedTypeVisitor does not support always go through the visitor, so that they still throw
+		bool stable = true, comparable = true;
+		vint hash = HashResolvedTypeInternal(t1, stable, comparable);
+		if (comparable)
+		{
+			if (t1 == t2 && stable) return true;
+			if (hash != HashResolvedType(t2)) return false;
+		}
+
 		IsSameResolvedTypeVisitor visitor;
 		visitor.peerType = t2;
 		t1->Accept(&visitor);
@@ -176,4 +188,178 @@ bool IsSameResolvedType(Ptr<Type> t1, Ptr<Type> t2)
 	{
 		return (t1 == nullptr) == (t2 == nullptr);
 	}
+}
+
+/***********************************************************************
+HashResolvedType
+***********************************************************************/
+
+class HashResolvedTypeVisitor : public Object, public virtual ITypeVisitor
+{
+public:
+	vuint					result = 0;
+	bool					stable = true;
+	bool					comparable = true;
+
+	void Combine(vuint value)
+	{
+		result = result * 31 + value;
+	}
+
+	void Combine(Ptr<Type> type)
+	{
+		Combine((vuint)HashResolvedTypeInternal(type, stable, comparable));
+	}
+
+	void HashResolving(Ptr<Resolving> resolving)
+	{
+		// IdType and ChildType are compared by resolved symbols
+		// a forward declaration could be calibrated to its root later, so only the name is stable
+		Combine(8);
+		if (resolving && resolving->resolvedSymbols.Count() > 0)
+		{
+			Combine(Symbol::GetNameHash(resolving->resolvedSymbols[0]->name));
+		}
+		else
+		{
+			// the type could still be resolved later
+			stable = false;
+		}
+	}
+
+	void Visit(PrimitiveType* self)override
+	{
+		Combine(1);
+		Combine((vuint)self->prefix);
+		Combine((vuint)self->primitive);
+	}
+
+	void Visit(ReferenceType* self)override
+	{
+		Combine(2);
+		Combine((vuint)self->reference);
+		Combine(self->type);
+	}
+
+	void Visit(ArrayType* self)override
+	{
+		Combine(3);
+		Combine(self->type);
+	}
+
+	void Visit(CallingConventionType* self)override
+	{
+		Combine(4);
+		Combine((vuint)self->callingConvention);
+		Combine(self->type);
+	}
+
+	void Visit(FunctionType* self)override
+	{
+		Combine(5);
+		Combine((self->qualifierConstExpr ? 1 : 0) | (self->qualifierConst ? 2 : 0) | (self->qualifierVolatile ? 4 : 0) | (self->qualifierLRef ? 8 : 0) | (self->qualifierRRef ? 16 : 0));
+		Combine(self->returnType);
+		Combine(self->decoratorReturnType);
+		Combine(self->parameters.Count());
+		for (vint i = 0; i < self->parameters.Count(); i++)
+		{
+			Combine(self->parameters[i]->type);
+		}
+	}
+
+	void Visit(MemberType* self)override
+	{
+		Combine(6);
+		Combine(self->classType);
+		Combine(self->type);
+	}
+
+	void Visit(DeclType* self)override
+	{
+		Combine(7);
+		comparable = false;
+	}
+
+	void Visit(DecorateType* self)override
+	{
+		Combine(9);
+		Combine((self->isConstExpr ? 1 : 0) | (self->isConst ? 2 : 0) | (self->isVolatile ? 4 : 0));
+		Combine(self->type);
+	}
+
+	void Visit(RootType* self)override
+	{
+		Combine(10);
+	}
+
+	void Visit(IdType* self)override
+	{
+		HashResolving(self->resolving);
+	}
+
+	void Visit(ChildType* self)override
+	{
+		HashResolving(self->resolving);
+	}
+
+	void Visit(GenericType* self)override
+	{
+		// arguments are not hashed, because they are not compared in IsSameResolvedType
+		Combine(11);
+		Combine(self->type);
+		Combine(self->arguments.Count());
+
+		for (vint i = 0; i < self->arguments.Count(); i++)
+		{
+			if (auto type = self->arguments[i].type)
+			{
+				HashResolvedTypeInternal(type, stable, comparable);
+			}
+			else
+			{
+				comparable = false;
+			}
+		}
+	}
+
+	void Visit(VariadicTemplateArgumentType* self)override
+	{
+		Combine(12);
+		Combine(self->type);
+	}
+};
+
+// Hash a type consistently with IsSameResolvedType
+//   if IsSameResolvedType(t1, t2), then HashResolvedType(t1) == HashResolvedType(t2)
+//   the hash is cached in the type when all resolvings inside are available
+//   comparable is set to false if IsSameResolvedType does not support the type
+vint HashResolvedTypeInternal(Ptr<Type> t, bool& stable, bool& comparable)
+{
+	if (!t) return 0;
+	if (t->resolvedHashCached)
+	{
+		if (!t->resolvedHashComparable) comparable = false;
+		return t->resolvedHash;
+	}
+
+	HashResolvedTypeVisitor visitor;
+	t->Accept(&visitor);
+	if (visitor.stable)
+	{
+		t->resolvedHash = (vint)visitor.result;
+		t->resolvedHashComparable = visitor.comparable;
+		t->resolvedHashCached = true;
+	}
+	else
+	{
+		stable = false;
+	}
+	if (!visitor.comparable) comparable = false;
+	return (vint)visitor.result;
+}
+
+vint HashResolvedType(Ptr<Type> t)
+{
+	bool stable = true, comparable = true;
+	return HashResolvedTypeInternal(t, stable, comparable);
 }
\ No newline at end of file
@@ -32,54 +32,54 @@ public:
 		case CppPrimitivePrefix::_none:
 			switch (self->primitive)
 			{
-			case CppPrimitiveType::_void:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::Void,		TsysBytes::_1 })); return;
-			case CppPrimitiveType::_bool:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::Bool,		TsysBytes::_1 })); return;
-			case CppPrimitiveType::_char:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SChar,		TsysBytes::_1 })); return;
-			case CppPrimitiveType::_wchar_t:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UWChar,	TsysBytes::_2 })); return;
-			case CppPrimitiveType::_char16_t:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UChar,		TsysBytes::_2 })); return;
-			case CppPrimitiveType::_char32_t:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UChar,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::_short:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_2 })); return;
-			case CppPrimitiveType::_int:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::___int8:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_1 })); return;
-			case CppPrimitiveType::___int16:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_2 })); return;
-			case CppPrimitiveType::___int32:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::___int64:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_8 })); return;
-			case CppPrimitiveType::_long:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::_long_int:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::_long_long:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_8 })); return;
-			case CppPrimitiveType::_float:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::Float,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::_double:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::Float,		TsysBytes::_8 })); return;
-			case CppPrimitiveType::_long_double:	result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::Float,		TsysBytes::_8 })); return;
+			case CppPrimitiveType::_void:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Void,		TsysBytes::_1 })); return;
+			case CppPrimitiveType::_bool:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Bool,		TsysBytes::_1 })); return;
+			case CppPrimitiveType::_char:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SChar,		TsysBytes::_1 })); return;
+			case CppPrimitiveType::_wchar_t:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UWChar,	TsysBytes::_2 })); return;
+			case CppPrimitiveType::_char16_t:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UChar,		TsysBytes::_2 })); return;
+			case CppPrimitiveType::_char32_t:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UChar,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::_short:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_2 })); return;
+			case CppPrimitiveType::_int:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::___int8:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_1 })); return;
+			case CppPrimitiveType::___int16:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_2 })); return;
+			case CppPrimitiveType::___int32:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::___int64:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_8 })); return;
+			case CppPrimitiveType::_long:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::_long_int:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::_long_long:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_8 })); return;
+			case CppPrimitiveType::_float:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Float,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::_double:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Float,		TsysBytes::_8 })); return;
+			case CppPrimitiveType::_long_double:	result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Float,		TsysBytes::_8 })); return;
 			}
 			break;
 		case CppPrimitivePrefix::_signed:
 			switch (self->primitive)
 			{
-			case CppPrimitiveType::_char:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_1 })); return;
-			case CppPrimitiveType::_short:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_2 })); return;
-			case CppPrimitiveType::_int:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::___int8:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_1 })); return;
-			case CppPrimitiveType::___int16:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_2 })); return;
-			case CppPrimitiveType::___int32:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::___int64:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_8 })); return;
-			case CppPrimitiveType::_long:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::_long_int:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::_long_long:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_8 })); return;
+			case CppPrimitiveType::_char:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_1 })); return;
+			case CppPrimitiveType::_short:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_2 })); return;
+			case CppPrimitiveType::_int:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::___int8:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_1 })); return;
+			case CppPrimitiveType::___int16:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_2 })); return;
+			case CppPrimitiveType::___int32:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::___int64:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_8 })); return;
+			case CppPrimitiveType::_long:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::_long_int:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::_long_long:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::SInt,		TsysBytes::_8 })); return;
 			}
 			break;
 		case CppPrimitivePrefix::_unsigned:
 			switch (self->primitive)
 			{
-			case CppPrimitiveType::_char:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_1 })); return;
-			case CppPrimitiveType::_short:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_2 })); return;
-			case CppPrimitiveType::_int:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::___int8:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_1 })); return;
-			case CppPrimitiveType::___int16:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_2 })); return;
-			case CppPrimitiveType::___int32:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::___int64:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_8 })); return;
-			case CppPrimitiveType::_long:			result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::_long_int:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_4 })); return;
-			case CppPrimitiveType::_long_long:		result.Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_8 })); return;
+			case CppPrimitiveType::_char:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_1 })); return;
+			case CppPrimitiveType::_short:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_2 })); return;
+			case CppPrimitiveType::_int:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::___int8:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_1 })); return;
+			case CppPrimitiveType::___int16:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_2 })); return;
+			case CppPrimitiveType::___int32:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::___int64:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_8 })); return;
+			case CppPrimitiveType::_long:			result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::_long_int:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_4 })); return;
+			case CppPrimitiveType::_long_long:		result.Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::UInt,		TsysBytes::_8 })); return;
 			}
 			break;
 		}
@@ -175,7 +175,7 @@ public:
 			}
 			else
 			{
-				tsyses[0].Add(pa.tsys->PrimitiveOf({ TsysPrimitiveType::Void,TsysBytes::_1 }));
+				tsyses[0].Add(pa.unit->tsys->PrimitiveOf({ TsysPrimitiveType::Void,TsysBytes::_1 }));
 			}
 
 			for (vint i = 0; i < self->parameters.Count(); i++)
@@ -239,7 +239,7 @@ public:
 				auto exprTsys = types[i].tsys;
 				if (exprTsys->GetType() == TsysType::Zero)
 				{
-					exprTsys = pa.tsys->Int();
+					exprTsys = pa.unit->tsys->Int();
 				}
 				if (!result.Contains(exprTsys))
 				{
@@ -274,7 +274,7 @@ public:
 		for (vint i = 0; i < resolving->resolvedSymbols.Count(); i++)
 		{
 			auto symbol = resolving->resolvedSymbols[i];
-			result.Add(pa.tsys->DeclOf(symbol));
+			result.Add(pa.unit->tsys->DeclOf(symbol));
 		}
 	}
 
@@ -300,9 +300,52 @@ public:
 };
 
 // Convert type AST to type system object
+//   results are cached in the type until any symbol table in the translation unit is changed
 void TypeToTsys(ParsingArguments& pa, Ptr<Type> t, TypeTsysList& tsys, TsysCallingConvention cc, bool memberOf)
 {
 	if (!t) throw NotConvertableException();
+
+	// the visitor rewrites existing items, so only an empty list could be filled from the cache
+	if (tsys.Count() > 0)
+	{
+		TypeToTsysVisitor visitor(pa, tsys, cc, memberOf);
+		t->Accept(&visitor);
+		return;
+	}
+
+	vint generation = pa.unit->GetGeneration();
+	if (!t->tsysCache)
+	{
+		t->tsysCache = MakePtr<TypeTsysCache>();
+	}
+
+	auto& entries = t->tsysCache->entries;
+	for (vint i = entries.Count() - 1; i >= 0; i--)
+	{
+		auto entry = entries[i];
+		if (entry->generation != generation)
+		{
+			entries.RemoveAt(i);
+		}
+		else if (entry->context == pa.context && entry->cc == cc && entry->memberOf == memberOf)
+		{
+			CopyFrom(tsys, entry->types);
+			return;
+		}
+	}
+
 	TypeToTsysVisitor visitor(pa, tsys, cc, memberOf);
 	t->Accept(&visitor);
+
+	// evaluating decltype could create symbols, the result is only cached when nothing is changed
+	if (generation == pa.unit->GetGeneration())
+	{
+		auto entry = MakePtr<TypeTsysCache::Entry>();
+		entry->context = pa.context;
+		entry->cc = cc;
+		entry->memberOf = memberOf;
+		entry->generation = generation;
+		CopyFrom(entry->types, tsys);
+		t->tsysCache->entries.Add(entry);
+	}
 }
\ No newline at end of file
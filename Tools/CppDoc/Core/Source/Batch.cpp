@@ -0,0 +1,169 @@
+#include "Batch.h"
+
+/***********************************************************************
+IndexBatch
+***********************************************************************/
+
+void IndexBatch::IndexFile(Ptr<RegexLexer> lexer, IndexBatchFile& file)
+{
+	auto start = DateTime::LocalTime().totalMilliseconds;
+	WString input;
+	if (!File(file.input).ReadAllTextByBom(input))
+	{
+		file.error = L"Cannot read the file.";
+	}
+	else
+	{
+		file.characters = input.Length();
+		try
+		{
+			// every file has its own symbol table and type system, nothing is shared between workers
+			auto recorder = MakePtr<IndexRecorder>();
+			ParsingUnit unit(new Symbol, ITsysAlloc::Create(), recorder);
+			ParsingArguments pa(&unit);
+			CppTokenReader reader(lexer, input);
+			auto cursor = reader.GetFirstToken();
+			auto program = ParseProgram(pa, cursor);
+
+			FileStream stream(file.output.GetFullPath(), FileStream::WriteOnly);
+			if (stream.IsAvailable())
+			{
+				recorder->Save(stream);
+				file.records = recorder->GetRecordCount();
+				file.succeeded = true;
+			}
+			else
+			{
+				file.error = L"Cannot write the index file: " + file.output.GetFullPath();
+			}
+		}
+		// a failure only affects this file, the worker goes on with the next one
+		catch (const StopParsingException& e)
+		{
+			file.error = e.position
+				? L"Cannot parse at row " + itow(e.position->token.rowStart + 1) + L", column " + itow(e.position->token.columnStart + 1) + L"."
+				: L"Cannot parse at the end of the file.";
+		}
+		catch (const Error& e)
+		{
+			file.error = e.Description();
+		}
+		catch (const Exception& e)
+		{
+			file.error = e.Message();
+		}
+		catch (...)
+		{
+			file.error = L"Unknown failure while parsing.";
+		}
+	}
+	file.milliseconds = DateTime::LocalTime().totalMilliseconds - start;
+}
+
+void IndexBatch::RunWorker()
+{
+	auto lexer = CreateCppLexer();
+	while (true)
+	{
+		vint index = -1;
+		{
+			SpinLock::Scope scope(lock);
+			if (nextFile == files.Count()) break;
+			index = nextFile++;
+		}
+
+		auto& file = files[index];
+		IndexFile(lexer, file);
+		if (callback)
+		{
+			CriticalSection::Scope scope(callbackLock);
+			callback(file);
+		}
+	}
+}
+
+IndexBatch::IndexBatch(const FilePath& _outputFolder, vint _workerCount)
+	:outputFolder(_outputFolder)
+	, workerCount(_workerCount < 1 ? 1 : _workerCount)
+{
+}
+
+void IndexBatch::Add(const FilePath& input)
+{
+	// inputs with the same name in different folders get different output names
+	auto name = input.GetName();
+	auto outputName = name;
+	for (vint i = 2; outputNames.Contains(outputName); i++)
+	{
+		outputName = name + L"." + itow(i);
+	}
+	outputNames.Add(outputName);
+
+	IndexBatchFile file;
+	file.input = input;
+	file.output = outputFolder / (outputName + L".index");
+	files.Add(file);
+}
+
+vint IndexBatch::GetFileCount()
+{
+	return files.Count();
+}
+
+const IndexBatchFile& IndexBatch::GetFile(vint index)
+{
+	return files[index];
+}
+
+bool IndexBatch::Run(const FileCallback& _callback)
+{
+	Folder folder(outputFolder);
+	if (!folder.Exists() && !folder.Create(true)) return false;
+
+	callback = _callback;
+	nextFile = 0;
+
+	vint threadCount = workerCount < files.Count() ? workerCount : files.Count();
+	List<Thread*> threads;
+	for (vint i = 0; i < threadCount; i++)
+	{
+		threads.Add(Thread::CreateAndStart([this]() { RunWorker(); }, false));
+	}
+	for (vint i = 0; i < threads.Count(); i++)
+	{
+		threads[i]->Wait();
+		delete threads[i];
+	}
+	callback = {};
+	return true;
+}
+
+/***********************************************************************
+LoadIndexBatchManifest
+***********************************************************************/
+
+static bool IsAbsolutePath(const WString& path)
+{
+	if (path.Length() >= 2 && path[1] == L':') return true;
+	return path.Length() >= 1 && (path[0] == L'\\' || path[0] == L'/');
+}
+
+bool LoadIndexBatchManifest(const FilePath& manifest, List<FilePath>& inputs)
+{
+	// one file in each line, relative to the manifest, empty lines and lines beginning with # are skipped
+	List<WString> lines;
+	if (!File(manifest).ReadAllLinesByBom(lines)) return false;
+
+	auto folder = manifest.GetFolder();
+	for (vint i = 0; i < lines.Count(); i++)
+	{
+		auto line = lines[i];
+		if (line.Length() > 0 && line[line.Length() - 1] == L'\r')
+		{
+			line = line.Left(line.Length() - 1);
+		}
+		if (line.Length() == 0 || line[0] == L'#') continue;
+		inputs.Add(IsAbsolutePath(line) ? FilePath(line) : folder / line);
+	}
+	return true;
+}
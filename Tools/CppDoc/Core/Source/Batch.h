@@ -0,0 +1,53 @@
+#ifndef VCZH_DOCUMENT_CPPDOC_BATCH
+#define VCZH_DOCUMENT_CPPDOC_BATCH
+
+#include "Index.h"
+
+/***********************************************************************
+IndexBatch
+***********************************************************************/
+
+struct IndexBatchFile
+{
+	FilePath				input;
+	FilePath				output;
+	bool					succeeded = false;
+	WString					error;				// why the file is not indexed
+	vint					characters = 0;		// length of the input
+	vint					records = 0;		// records in the index
+	vuint64_t				milliseconds = 0;	// time to read, parse and save the file
+};
+
+// Indexes files in a fixed number of worker threads, each worker owns a lexer and works on one file at a time
+// The number of workers also bounds how many translation units are in memory
+class IndexBatch : public Object
+{
+	using FileCallback = Func<void(const IndexBatchFile&)>;
+protected:
+	FilePath				outputFolder;
+	vint					workerCount;
+	List<IndexBatchFile>	files;
+	SortedList<WString>		outputNames;
+
+	SpinLock				lock;
+	vint					nextFile = 0;
+	CriticalSection			callbackLock;
+	FileCallback			callback;
+
+	void					IndexFile(Ptr<RegexLexer> lexer, IndexBatchFile& file);
+	void					RunWorker();
+public:
+	IndexBatch(const FilePath& _outputFolder, vint _workerCount);
+
+	void					Add(const FilePath& input);
+	vint					GetFileCount();
+	const IndexBatchFile&	GetFile(vint index);
+
+	// callback is called in worker threads one at a time when each file is done
+	// returns false if the output folder cannot be created, failures of files are reported in IndexBatchFile::succeeded and error
+	bool					Run(const FileCallback& _callback);
+};
+
+extern bool					LoadIndexBatchManifest(const FilePath& manifest, List<FilePath>& inputs);
+
+#endif
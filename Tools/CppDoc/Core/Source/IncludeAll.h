@@ -7,5 +7,8 @@
 #include "Ast_Type.h"
 #include "Ast_Decl.h"
 #include "Parser.h"
+#include "Index.h"
+#include "Snapshot.h"
+#include "Batch.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,474 @@
+#include "Index.h"
+
+/***********************************************************************
+IndexRecorder
+***********************************************************************/
+
+vint IndexRecorder::GetSymbolId(Symbol* symbol)
+{
+	vint index = symbolIdMap.Keys().IndexOf(symbol);
+	if (index != -1)
+	{
+		return symbolIdMap.Values()[index];
+	}
+
+	vint id = symbols.Add(symbol);
+	symbolIdMap.Add(symbol, id);
+	return id;
+}
+
+void IndexRecorder::Record(CppName& name, const Ptr<Resolving>& resolving, IndexReason reason)
+{
+	if (!name || !resolving) return;
+	for (vint i = 0; i < resolving->resolvedSymbols.Count(); i++)
+	{
+		offsets.Add(name.nameTokens[0].start);
+		symbolIds.Add(GetSymbolId(resolving->resolvedSymbols[i]));
+		reasons.Add(reason);
+	}
+}
+
+void IndexRecorder::Index(CppName& name, const Ptr<Resolving>& resolving)
+{
+	Record(name, resolving, IndexReason::Resolved);
+}
+
+void IndexRecorder::ExpectValueButType(CppName& name, const Ptr<Resolving>& resolving)
+{
+	Record(name, resolving, IndexReason::NeedValueButType);
+}
+
+vint IndexRecorder::GetRecordCount()
+{
+	return offsets.Count();
+}
+
+IndexRecord IndexRecorder::GetRecord(vint index)
+{
+	IndexRecord record;
+	record.offset = offsets[index];
+	record.symbolId = symbolIds[index];
+	record.reason = reasons[index];
+	return record;
+}
+
+vint IndexRecorder::GetSymbolCount()
+{
+	return symbols.Count();
+}
+
+Symbol* IndexRecorder::GetSymbol(vint symbolId)
+{
+	return symbols[symbolId];
+}
+
+/***********************************************************************
+Index File (Writing)
+***********************************************************************/
+
+static const vuint32_t		IndexFileMagic = 0x58494443;	// "CDIX"
+static const vuint32_t		IndexFileVersion = 2;
+static const vint			IndexFileHeaderCount = 8;
+
+static void WriteNumber(List<vuint8_t>& bytes, vuint64_t number)
+{
+	while (number >= 0x80)
+	{
+		bytes.Add((vuint8_t)(number | 0x80));
+		number >>= 7;
+	}
+	bytes.Add((vuint8_t)number);
+}
+
+static void WriteFixed(List<vuint8_t>& bytes, vint number)
+{
+	auto value = (vuint32_t)number;
+	bytes.Add((vuint8_t)value);
+	bytes.Add((vuint8_t)(value >> 8));
+	bytes.Add((vuint8_t)(value >> 16));
+	bytes.Add((vuint8_t)(value >> 24));
+}
+
+static void WriteBytes(IStream& stream, List<vuint8_t>& bytes)
+{
+	if (bytes.Count() > 0)
+	{
+		stream.Write((void*)&bytes[0], bytes.Count());
+	}
+}
+
+WString GetSymbolFullName(Symbol* symbol)
+{
+	WString name;
+	while (symbol && symbol->parent)
+	{
+		name = L"::" + symbol->name + name;
+		symbol = symbol->parent;
+	}
+	return name;
+}
+
+void IndexRecorder::Save(IStream& stream)
+{
+	vint recordCount = offsets.Count();
+	vint symbolCount = symbols.Count();
+
+	Array<vint> order(recordCount);
+	for (vint i = 0; i < recordCount; i++)
+	{
+		order[i] = i;
+	}
+	if (recordCount > 0)
+	{
+		SortLambda(&order[0], recordCount, [this](vint a, vint b) -> vint
+		{
+			if (offsets[a] != offsets[b]) return offsets[a] < offsets[b] ? -1 : 1;
+			if (symbolIds[a] != symbolIds[b]) return symbolIds[a] < symbolIds[b] ? -1 : 1;
+			return (vint)reasons[a] - (vint)reasons[b];
+		});
+	}
+
+	// records, the delta restarts at each block for point queries
+	List<vuint8_t> blockBytes, recordBytes;
+	{
+		vint lastOffset = 0;
+		for (vint i = 0; i < recordCount; i++)
+		{
+			vint index = order[i];
+			if (i % IndexFileBlockSize == 0)
+			{
+				WriteFixed(blockBytes, offsets[index]);
+				WriteFixed(blockBytes, recordBytes.Count());
+				lastOffset = offsets[index];
+			}
+			WriteNumber(recordBytes, (vuint64_t)(offsets[index] - lastOffset));
+			WriteNumber(recordBytes, ((vuint64_t)symbolIds[index] << 1) | (vuint64_t)reasons[index]);
+			lastOffset = offsets[index];
+		}
+	}
+
+	// references, grouped by symbols in one counting sort pass, offsets in each group keep sorted
+	List<vuint8_t> referenceStartBytes, referenceBytes;
+	{
+		Array<vint> rowStarts(symbolCount + 1);
+		for (vint i = 0; i <= symbolCount; i++)
+		{
+			rowStarts[i] = 0;
+		}
+		for (vint i = 0; i < recordCount; i++)
+		{
+			rowStarts[symbolIds[i] + 1]++;
+		}
+		for (vint i = 0; i < symbolCount; i++)
+		{
+			rowStarts[i + 1] += rowStarts[i];
+		}
+
+		Array<vint> rowFills(symbolCount);
+		Array<vint> rowOffsets(recordCount);
+		for (vint i = 0; i < symbolCount; i++)
+		{
+			rowFills[i] = rowStarts[i];
+		}
+		for (vint i = 0; i < recordCount; i++)
+		{
+			vint index = order[i];
+			rowOffsets[rowFills[symbolIds[index]]++] = offsets[index];
+		}
+
+		for (vint i = 0; i < symbolCount; i++)
+		{
+			WriteFixed(referenceStartBytes, referenceBytes.Count());
+			vint lastOffset = 0;
+			for (vint j = rowStarts[i]; j < rowStarts[i + 1]; j++)
+			{
+				WriteNumber(referenceBytes, (vuint64_t)(rowOffsets[j] - lastOffset));
+				lastOffset = rowOffsets[j];
+			}
+		}
+		WriteFixed(referenceStartBytes, referenceBytes.Count());
+	}
+
+	List<vuint8_t> nameStartBytes, symbolBytes;
+	for (vint i = 0; i < symbolCount; i++)
+	{
+		WriteFixed(nameStartBytes, symbolBytes.Count());
+		auto name = GetSymbolFullName(symbols[i]);
+		WriteNumber(symbolBytes, (vuint64_t)name.Length());
+		for (vint j = 0; j < name.Length(); j++)
+		{
+			WriteNumber(symbolBytes, (vuint64_t)name[j]);
+		}
+	}
+	WriteFixed(nameStartBytes, symbolBytes.Count());
+
+	List<vuint8_t> headerBytes;
+	WriteFixed(headerBytes, IndexFileMagic);
+	WriteFixed(headerBytes, IndexFileVersion);
+	WriteFixed(headerBytes, recordCount);
+	WriteFixed(headerBytes, symbolCount);
+	WriteFixed(headerBytes, blockBytes.Count() / 8);
+	WriteFixed(headerBytes, recordBytes.Count());
+	WriteFixed(headerBytes, referenceBytes.Count());
+	WriteFixed(headerBytes, symbolBytes.Count());
+
+	WriteBytes(stream, headerBytes);
+	WriteBytes(stream, blockBytes);
+	WriteBytes(stream, referenceStartBytes);
+	WriteBytes(stream, nameStartBytes);
+	WriteBytes(stream, recordBytes);
+	WriteBytes(stream, referenceBytes);
+	WriteBytes(stream, symbolBytes);
+}
+
+/***********************************************************************
+Index File (Reading)
+***********************************************************************/
+
+static vint ReadFixed(const vuint8_t* bytes, vint index)
+{
+	bytes += index * 4;
+	return (vint)((vuint32_t)bytes[0] | ((vuint32_t)bytes[1] << 8) | ((vuint32_t)bytes[2] << 16) | ((vuint32_t)bytes[3] << 24));
+}
+
+static bool ReadNumber(const vuint8_t* bytes, vint& position, vint end, vuint64_t& number)
+{
+	number = 0;
+	vint shift = 0;
+	while (position < end && shift < 64)
+	{
+		auto byte = bytes[position++];
+		number |= (vuint64_t)(byte & 0x7F) << shift;
+		if (byte < 0x80) return true;
+		shift += 7;
+	}
+	return false;
+}
+
+static bool IsValidStarts(const vuint8_t* starts, vint count, vint end)
+{
+	vint last = 0;
+	for (vint i = 0; i <= count; i++)
+	{
+		vint current = ReadFixed(starts, i);
+		if (current < last || current > end) return false;
+		last = current;
+	}
+	return ReadFixed(starts, count) == end;
+}
+
+static bool IsValidSymbol(vuint64_t packed, vint symbolCount)
+{
+	// a record referring to a symbol that doesn't exist is treated like a truncated record
+	return (packed >> 1) < (vuint64_t)symbolCount;
+}
+
+static bool ReserveBytes(vint& offset, vint size, vint count, vint itemSize)
+{
+	// count comes from the file, it is compared before being multiplied so that it never overflows
+	if (count < 0 || count > (size - offset) / itemSize) return false;
+	offset += count * itemSize;
+	return true;
+}
+
+IndexFileView::IndexFileView(const vuint8_t* _buffer, vint _size)
+	:buffer(_buffer)
+	, size(_size)
+{
+	if (size < IndexFileHeaderCount * 4) return;
+	if ((vuint32_t)ReadFixed(buffer, 0) != IndexFileMagic) return;
+	if ((vuint32_t)ReadFixed(buffer, 1) != IndexFileVersion) return;
+
+	recordCount = ReadFixed(buffer, 2);
+	symbolCount = ReadFixed(buffer, 3);
+	blockCount = ReadFixed(buffer, 4);
+	vint recordSize = ReadFixed(buffer, 5);
+	vint referenceSize = ReadFixed(buffer, 6);
+	vint symbolSize = ReadFixed(buffer, 7);
+
+	if (recordCount < 0 || symbolCount < 0) return;
+	if (blockCount != recordCount / IndexFileBlockSize + (recordCount % IndexFileBlockSize == 0 ? 0 : 1)) return;
+
+	vint offset = IndexFileHeaderCount * 4;
+	blocks = buffer + offset;
+	if (!ReserveBytes(offset, size, blockCount, 8)) return;
+	referenceStarts = buffer + offset;
+	if (!ReserveBytes(offset, size, symbolCount + 1, 4)) return;
+	nameStarts = buffer + offset;
+	if (!ReserveBytes(offset, size, symbolCount + 1, 4)) return;
+	records = buffer + offset;
+	if (!ReserveBytes(offset, size, recordSize, 1)) return;
+	references = buffer + offset;
+	if (!ReserveBytes(offset, size, referenceSize, 1)) return;
+	names = buffer + offset;
+	if (!ReserveBytes(offset, size, symbolSize, 1)) return;
+	if (offset != size) return;
+
+	// each record takes at least two bytes
+	if (recordCount > recordSize / 2) return;
+
+	for (vint i = 0; i < blockCount; i++)
+	{
+		vint position = ReadFixed(blocks, i * 2 + 1);
+		if (position < 0 || position > recordSize) return;
+		if (i > 0 && position < ReadFixed(blocks, i * 2 - 1)) return;
+	}
+	if (!IsValidStarts(referenceStarts, symbolCount, referenceSize)) return;
+	if (!IsValidStarts(nameStarts, symbolCount, symbolSize)) return;
+	valid = true;
+}
+
+bool IndexFileView::IsValid()
+{
+	return valid;
+}
+
+vint IndexFileView::GetRecordCount()
+{
+	return recordCount;
+}
+
+vint IndexFileView::GetSymbolCount()
+{
+	return symbolCount;
+}
+
+WString IndexFileView::GetSymbolName(vint symbolId)
+{
+	CHECK_ERROR(valid && 0 <= symbolId && symbolId < symbolCount, L"IndexFileView::GetSymbolName(vint)#Argument symbolId not in range.");
+	vint position = ReadFixed(nameStarts, symbolId);
+	vint end = ReadFixed(nameStarts, symbolId + 1);
+
+	vuint64_t length = 0;
+	if (!ReadNumber(names, position, end, length) || (vint)length > end - position) return WString::Empty;
+
+	Array<wchar_t> buffer((vint)length + 1);
+	for (vint i = 0; i < (vint)length; i++)
+	{
+		vuint64_t c = 0;
+		if (!ReadNumber(names, position, end, c)) return WString::Empty;
+		buffer[i] = (wchar_t)c;
+	}
+	buffer[(vint)length] = 0;
+	return &buffer[0];
+}
+
+void IndexFileView::GetRecords(List<IndexRecord>& result)
+{
+	if (!valid) return;
+	vint recordEnd = references - records;
+	for (vint i = 0; i < blockCount; i++)
+	{
+		vint lastOffset = ReadFixed(blocks, i * 2);
+		vint position = ReadFixed(blocks, i * 2 + 1);
+		vint count = i == blockCount - 1 ? recordCount - i * IndexFileBlockSize : IndexFileBlockSize;
+		for (vint j = 0; j < count; j++)
+		{
+			vuint64_t delta = 0, packed = 0;
+			if (!ReadNumber(records, position, recordEnd, delta)) return;
+			if (!ReadNumber(records, position, recordEnd, packed)) return;
+			if (!IsValidSymbol(packed, symbolCount)) return;
+
+			IndexRecord record;
+			record.offset = lastOffset + (vint)delta;
+			record.symbolId = (vint)(packed >> 1);
+			record.reason = (IndexReason)(packed & 1);
+			result.Add(record);
+			lastOffset = record.offset;
+		}
+	}
+}
+
+void IndexFileView::FindSymbolsAt(vint offset, List<vint>& symbolIds)
+{
+	if (!valid || blockCount == 0) return;
+
+	// find the last block starting before the offset, records at the offset could begin at the end of it
+	vint start = 0, end = blockCount - 1;
+	while (start < end)
+	{
+		vint middle = (start + end + 1) / 2;
+		if (ReadFixed(blocks, middle * 2) < offset)
+		{
+			start = middle;
+		}
+		else
+		{
+			end = middle - 1;
+		}
+	}
+
+	vint recordEnd = references - records;
+	for (vint i = start; i < blockCount; i++)
+	{
+		vint lastOffset = ReadFixed(blocks, i * 2);
+		if (lastOffset > offset) return;
+
+		vint position = ReadFixed(blocks, i * 2 + 1);
+		vint count = i == blockCount - 1 ? recordCount - i * IndexFileBlockSize : IndexFileBlockSize;
+		for (vint j = 0; j < count; j++)
+		{
+			vuint64_t delta = 0, packed = 0;
+			if (!ReadNumber(records, position, recordEnd, delta)) return;
+			if (!ReadNumber(records, position, recordEnd, packed)) return;
+			if (!IsValidSymbol(packed, symbolCount)) return;
+
+			lastOffset += (vint)delta;
+			if (lastOffset > offset) return;
+			if (lastOffset == offset)
+			{
+				vint symbolId = (vint)(packed >> 1);
+				if (!symbolIds.Contains(symbolId))
+				{
+					symbolIds.Add(symbolId);
+				}
+			}
+		}
+	}
+}
+
+void IndexFileView::FindReferences(vint symbolId, List<vint>& offsets)
+{
+	CHECK_ERROR(valid && 0 <= symbolId && symbolId < symbolCount, L"IndexFileView::FindReferences(vint, List<vint>&)#Argument symbolId not in range.");
+	vint position = ReadFixed(referenceStarts, symbolId);
+	vint end = ReadFixed(referenceStarts, symbolId + 1);
+
+	vint lastOffset = 0;
+	while (position < end)
+	{
+		vuint64_t delta = 0;
+		if (!ReadNumber(references, position, end, delta)) return;
+		lastOffset += (vint)delta;
+		offsets.Add(lastOffset);
+	}
+}
+
+bool LoadIndex(IStream& stream, List<IndexRecord>& records, List<WString>& symbolNames)
+{
+	records.Clear();
+	symbolNames.Clear();
+
+	List<vuint8_t> bytes;
+	{
+		vuint8_t buffer[65536];
+		while (true)
+		{
+			vint read = stream.Read(buffer, sizeof(buffer));
+			if (read <= 0) break;
+			CopyFrom(bytes, (const vuint8_t*)buffer, read, true);
+		}
+	}
+	if (bytes.Count() == 0) return false;
+
+	IndexFileView view(&bytes[0], bytes.Count());
+	if (!view.IsValid()) return false;
+
+	view.GetRecords(records);
+	if (records.Count() != view.GetRecordCount()) return false;
+
+	for (vint i = 0; i < view.GetSymbolCount(); i++)
+	{
+		symbolNames.Add(view.GetSymbolName(i));
+	}
+	return true;
+}
@@ -0,0 +1,104 @@
+#ifndef VCZH_DOCUMENT_CPPDOC_INDEX
+#define VCZH_DOCUMENT_CPPDOC_INDEX
+
+#include "Parser.h"
+
+/***********************************************************************
+IndexRecord
+***********************************************************************/
+
+enum class IndexReason : vuint8_t
+{
+	Resolved,				// IIndexRecorder::Index
+	NeedValueButType,		// IIndexRecorder::ExpectValueButType
+};
+
+struct IndexRecord
+{
+	vint					offset = 0;		// position of the first token of the name in the input
+	vint					symbolId = -1;	// index in the symbol table of the index
+	IndexReason				reason = IndexReason::Resolved;
+};
+
+/***********************************************************************
+IndexRecorder
+***********************************************************************/
+
+// Records are stored in columns, a new event only appends numbers to them
+class IndexRecorder : public Object, public virtual IIndexRecorder
+{
+protected:
+	List<vint>				offsets;
+	List<vint>				symbolIds;
+	List<IndexReason>		reasons;
+
+	Dictionary<Symbol*, vint>	symbolIdMap;
+	List<Symbol*>			symbols;
+
+	vint					GetSymbolId(Symbol* symbol);
+	void					Record(CppName& name, const Ptr<Resolving>& resolving, IndexReason reason);
+public:
+	void					Index(CppName& name, const Ptr<Resolving>& resolving)override;
+	void					ExpectValueButType(CppName& name, const Ptr<Resolving>& resolving)override;
+
+	vint					GetRecordCount();
+	IndexRecord				GetRecord(vint index);
+	vint					GetSymbolCount();
+	Symbol*					GetSymbol(vint symbolId);
+
+	void					Save(IStream& stream);
+};
+
+/***********************************************************************
+Index File
+***********************************************************************/
+
+// File layout, all fixed size numbers are 32 bits little endian, other numbers are in variable length:
+//   header:		magic, version, record count, symbol count, block count, size of records, size of references, size of symbols
+//   blocks:		(first offset, position in records) for every IndexFileBlockSize records
+//   references:	position in references for each symbol, and the end of references
+//   names:			position in symbols for each symbol, and the end of symbols
+//   records:		sorted by offset, each one is (offset delta, symbol id * 2 + reason), delta restarts at each block
+//   references:	for each symbol, offsets of all records referencing it in (offset delta)
+//   symbols:		for each symbol, (name length, name characters)
+// Fixed size tables are placed right after the header, so that they could be searched in a mapped file directly
+
+constexpr vint				IndexFileBlockSize = 64;
+
+extern WString				GetSymbolFullName(Symbol* symbol);
+
+// Query an index file in memory without loading it
+class IndexFileView : public Object
+{
+protected:
+	const vuint8_t*			buffer = nullptr;
+	vint					size = 0;
+	bool					valid = false;
+
+	vint					recordCount = 0;
+	vint					symbolCount = 0;
+	vint					blockCount = 0;
+	const vuint8_t*			blocks = nullptr;
+	const vuint8_t*			referenceStarts = nullptr;
+	const vuint8_t*			nameStarts = nullptr;
+	const vuint8_t*			records = nullptr;
+	const vuint8_t*			references = nullptr;
+	const vuint8_t*			names = nullptr;
+
+public:
+	IndexFileView(const vuint8_t* _buffer, vint _size);
+
+	bool					IsValid();
+	vint					GetRecordCount();
+	vint					GetSymbolCount();
+	WString					GetSymbolName(vint symbolId);
+
+	// decoding stops at the first corrupted record, so symbol ids returned by these functions are always in range
+	void					GetRecords(List<IndexRecord>& result);
+	void					FindSymbolsAt(vint offset, List<vint>& symbolIds);
+	void					FindReferences(vint symbolId, List<vint>& offsets);
+};
+
+extern bool					LoadIndex(IStream& stream, List<IndexRecord>& records, List<WString>& symbolNames);
+
+#endif
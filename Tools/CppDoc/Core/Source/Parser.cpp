@@ -1,36 +1,183 @@
 #include "Parser.h"
+#include "Ast_Decl.h"
 
 /***********************************************************************
 Symbol
 ***********************************************************************/
 
+vuint32_t Symbol::GetNameHash(const WString& name)
+{
+	// FNV-1a
+	vuint32_t hash = 2166136261U;
+	auto reading = name.Buffer();
+	for (vint i = 0; i < name.Length(); i++)
+	{
+		hash = (hash ^ (vuint32_t)reading[i]) * 16777619U;
+	}
+	return hash;
+}
+
+vuint64_t Symbol::GetNameFilter(const WString& name)
+{
+	// two bits out of 64 are taken from the hash
+	auto hash = GetNameHash(name);
+	return ((vuint64_t)1 << (hash & 63)) | ((vuint64_t)1 << ((hash >> 6) & 63));
+}
+
+Symbol* Symbol::GetRoot()
+{
+	auto root = this;
+	while (root->parent) root = root->parent;
+	return root;
+}
+
+void Symbol::IncreaseGeneration()
+{
+	GetRoot()->generation++;
+}
+
+static bool IsDeclaredInEnclosingScopes(Symbol* scope, const WString& name)
+{
+	auto nameFilter = Symbol::GetNameFilter(name);
+	for (auto current = scope->parent; current; current = current->parent)
+	{
+		if (current->MayContainChild(nameFilter) && current->children.Keys().Contains(name))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 void Symbol::Add(Ptr<Symbol> child)
 {
 	child->parent = this;
 	children.Add(child->name, child);
+	childrenFilter |= GetNameFilter(child->name);
+
+	// local variables and nested statements only affect code after them, which has not been evaluated yet
+	// but a local variable hiding an outer name is treated like any other change, because cached results may refer to that name
+	if (stat)
+	{
+		if (child->stat) return;
+		if (child->decls.Count() > 0 && child->decls[0].Cast<ForwardVariableDeclaration>() && !IsDeclaredInEnclosingScopes(this, child->name)) return;
+	}
+	IncreaseGeneration();
+}
+
+void Symbol::AddUsingNs(Symbol* usingNs)
+{
+	if (usingNss.Contains(usingNs)) return;
+	usingNss.Add(usingNs);
+	usingNs->usingNssReferrers.Add(this);
+	IncreaseGeneration();
+
+	// scopes that nominate this scope directly or indirectly see new namespaces transitively
+	SymbolPtrList scopes;
+	scopes.Add(this);
+	for (vint i = 0; i < scopes.Count(); i++)
+	{
+		auto scope = scopes[i];
+		scope->BuildUsingNssClosure();
+		for (vint j = 0; j < scope->usingNssReferrers.Count(); j++)
+		{
+			auto referrer = scope->usingNssReferrers[j];
+			if (!scopes.Contains(referrer))
+			{
+				scopes.Add(referrer);
+			}
+		}
+	}
+}
+
+void Symbol::BuildUsingNssClosure()
+{
+	usingNssClosure.Clear();
+	usingNssClosureDepths.Clear();
+
+	// breadth-first, so that each namespace is recorded with the fewest using directives to reach it
+	for (vint i = 0; i < usingNss.Count(); i++)
+	{
+		auto ns = usingNss[i];
+		if (ns != this && !usingNssClosure.Contains(ns))
+		{
+			usingNssClosure.Add(ns);
+			usingNssClosureDepths.Add(1);
+		}
+	}
+
+	for (vint i = 0; i < usingNssClosure.Count(); i++)
+	{
+		auto nominated = usingNssClosure[i];
+		for (vint j = 0; j < nominated->usingNss.Count(); j++)
+		{
+			auto ns = nominated->usingNss[j];
+			if (ns != this && !usingNssClosure.Contains(ns))
+			{
+				usingNssClosure.Add(ns);
+				usingNssClosureDepths.Add(usingNssClosureDepths[i] + 1);
+			}
+		}
+	}
 }
 
 /***********************************************************************
-ParsingArguments
+ParsingUnit
 ***********************************************************************/
 
-ParsingArguments::ParsingArguments()
+ParsingUnit::ParsingUnit()
 {
 }
 
-ParsingArguments::ParsingArguments(Ptr<Symbol> _root, Ptr<ITsysAlloc> _tsys, Ptr<IIndexRecorder> _recorder)
+ParsingUnit::ParsingUnit(Ptr<Symbol> _root, Ptr<ITsysAlloc> _tsys, Ptr<IIndexRecorder> _recorder)
 	:root(_root)
-	, context(_root.Obj())
 	, tsys(_tsys)
 	, recorder(_recorder)
+{
+	ActivateTsys();
+}
+
+void ParsingUnit::ActivateTsys()
+{
+	// scopes are nested in a thread, the previous one is released before a new one is created
+	overlayScope = nullptr;
+	if (tsys && tsys->IsOverlay())
+	{
+		overlayScope = new TsysOverlayScope(tsys);
+	}
+}
+
+// Cached results are only stamped with the generation, so replacing the allocator or the recorder starts a new one
+void ParsingUnit::SetTsys(Ptr<ITsysAlloc> _tsys)
+{
+	tsys = _tsys;
+	ActivateTsys();
+	if (root) root->generation++;
+}
+
+void ParsingUnit::SetRecorder(Ptr<IIndexRecorder> _recorder)
+{
+	recorder = _recorder;
+	if (root) root->generation++;
+}
+
+/***********************************************************************
+ParsingArguments
+***********************************************************************/
+
+ParsingArguments::ParsingArguments()
+{
+}
+
+ParsingArguments::ParsingArguments(ParsingUnit* _unit)
+	:unit(_unit)
+	, context(_unit->root.Obj())
 {
 }
 
 ParsingArguments::ParsingArguments(const ParsingArguments& pa, Symbol* _context)
-	:root(pa.root)
+	:unit(pa.unit)
 	, context(_context)
-	, tsys(pa.tsys)
-	, recorder(pa.recorder)
 {
 }
 
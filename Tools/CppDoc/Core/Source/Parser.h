@@ -9,6 +9,18 @@
 Symbol
 ***********************************************************************/
 
+class ClassMemberCache;
+class OperatorCandidateCache;
+
+struct SymbolFunctionArity
+{
+	bool					cached = false;
+	bool					isFunction = false;
+	vint					minParameterCount = 0;	// parameters without default values
+	vint					maxParameterCount = 0;	// all parameters
+	bool					ellipsis = false;
+};
+
 class Symbol : public Object
 {
 	using SymbolGroup = Group<WString, Ptr<Symbol>>;
@@ -19,6 +31,7 @@ public:
 	List<Ptr<Declaration>>	decls;			// only namespaces share symbols
 	Ptr<Stat>				stat;			// if this scope is created by a statement
 	SymbolGroup				children;
+	vuint64_t				childrenFilter = 0;	// bloom filter of names in children
 
 	Ptr<TypeTsysList>		resolvedTypes;	// only for Forward(Variable|Function)Declaration of which has a pending type
 
@@ -29,9 +42,28 @@ public:
 	Symbol*					specializationRoot = nullptr;
 	SymbolPtrList			specializations;
 
-	SymbolPtrList			usingNss;
+	Group<vint, Symbol*>	forwardSignatures;	// children that could be connected as forward declarations, indexed by name and signature
 
+	SymbolPtrList			usingNss;
+	SymbolPtrList			usingNssClosure;		// all namespaces nominated by usingNss directly or indirectly, ordered by depth
+	List<vint>				usingNssClosureDepths;	// the number of using directives to reach each namespace in usingNssClosure
+	SymbolPtrList			usingNssReferrers;		// scopes of which usingNss contains this namespace
+
+	Ptr<ClassMemberCache>	classMemberCache;	// only for ClassDeclaration of which base types are all parsed
+	bool					isCompleteClass = false;	// only for ClassDeclaration of which members are all parsed
+	Ptr<OperatorCandidateCache>	operatorCandidateCache;	// only for types of which overloaded operators have been searched
+	SymbolFunctionArity		functionArity;			// only for ForwardFunctionDeclaration which has been an overloading candidate
+
+	vint					generation = 0;			// only for the root symbol, increased when any symbol table in this translation unit is changed
+
+	static vuint32_t		GetNameHash(const WString& name);
+	static vuint64_t		GetNameFilter(const WString& name);
+	bool					MayContainChild(vuint64_t nameFilter) { return (childrenFilter & nameFilter) == nameFilter; }
+	Symbol*					GetRoot();
+	void					IncreaseGeneration();
 	void					Add(Ptr<Symbol> child);
+	void					AddUsingNs(Symbol* usingNs);
+	void					BuildUsingNssClosure();
 
 	Symbol* CreateDeclSymbol(Ptr<Declaration> _decl, Symbol* _specializationRoot = nullptr)
 	{
@@ -69,6 +101,7 @@ public:
 		if (forwardDeclarationRoot) return false;
 		forwardDeclarationRoot = root;
 		root->forwardDeclarations.Add(this);
+		IncreaseGeneration();
 		return true;
 	}
 };
@@ -80,8 +113,8 @@ Parsers
 class IIndexRecorder : public virtual Interface
 {
 public:
-	virtual void			Index(CppName& name, Ptr<Resolving> resolving) = 0;
-	virtual void			ExpectValueButType(CppName& name, Ptr<Resolving> resolving) = 0;
+	virtual void			Index(CppName& name, const Ptr<Resolving>& resolving) = 0;
+	virtual void			ExpectValueButType(CppName& name, const Ptr<Resolving>& resolving) = 0;
 };
 
 enum class DeclaratorRestriction
@@ -98,15 +131,37 @@ enum class InitializerRestriction
 	Optional,
 };
 
-struct ParsingArguments
+// Shared by all ParsingArguments of a translation unit, the caller keeps it alive while parsing
+class ParsingUnit : public Object
 {
+protected:
+	Ptr<TsysOverlayScope>	overlayScope;	// activates tsys in the thread that sets it, if it is an overlay
+
+	void					ActivateTsys();
+public:
 	Ptr<Symbol>				root;
+	Ptr<ITsysAlloc>			tsys;			// replaced by SetTsys
+	Ptr<IIndexRecorder>		recorder;		// replaced by SetRecorder
+
+	bool					exprTsysCacheEnabled = true;	// turn on or off caching in ExprToTsys
+	ExprTsysCacheStatistics	exprTsysCacheStatistics;
+
+	ParsingUnit();
+	ParsingUnit(Ptr<Symbol> _root, Ptr<ITsysAlloc> _tsys, Ptr<IIndexRecorder> _recorder);
+
+	vint					GetGeneration() { return root ? root->generation : 0; }
+	void					SetTsys(Ptr<ITsysAlloc> _tsys);
+	void					SetRecorder(Ptr<IIndexRecorder> _recorder);
+};
+
+// Nested scopes only copy plain pointers
+struct ParsingArguments
+{
+	ParsingUnit*			unit = nullptr;
 	Symbol*					context = nullptr;
-	Ptr<ITsysAlloc>			tsys;
-	Ptr<IIndexRecorder>		recorder;
 
 	ParsingArguments();
-	ParsingArguments(Ptr<Symbol> _root, Ptr<ITsysAlloc> _tsys, Ptr<IIndexRecorder> _recorder);
+	ParsingArguments(ParsingUnit* _unit);
 	ParsingArguments(const ParsingArguments& pa, Symbol* _context);
 };
 
@@ -138,6 +193,28 @@ struct ResolveSymbolResult
 	void							Merge(Ptr<Resolving>& to, Ptr<Resolving> from);
 	void							Merge(const ResolveSymbolResult& rar);
 };
+
+class ClassMemberCache : public Object
+{
+	using ResultMap = Dictionary<WString, Ptr<ResolveSymbolResult>>;
+public:
+	ResultMap						inheritedMembers;				// members found in base classes for SearchPolicy::ChildSymbol
+	ResultMap						inheritedMembersFromSubClass;	// members found in base classes for SearchPolicy::ChildSymbolRequestedFromSubClass
+};
+
+class OperatorCandidateCache : public Object
+{
+public:
+	struct Candidates
+	{
+		vint						generation = 0;		// generation of the root symbol when candidates are found
+		ResolveSymbolResult			methods;			// operators in the type
+		ResolveSymbolResult			funcs;				// operators in the scope containing the type
+	};
+
+	Dictionary<WString, Ptr<Candidates>>	candidates;	// indexed by operator names
+};
+
 extern ResolveSymbolResult			ResolveSymbol(const ParsingArguments& pa, CppName& name, SearchPolicy policy, ResolveSymbolResult input = {});
 extern ResolveSymbolResult			ResolveChildSymbol(const ParsingArguments& pa, Ptr<Type> classType, CppName& name, ResolveSymbolResult input = {});
 
@@ -7,9 +7,22 @@
 FindForward
 ***********************************************************************/
 
+template<typename TForward>
+struct ForwardCategory;
+
+template<> struct ForwardCategory<ForwardVariableDeclaration>	{ static const vint Tag = 0; };
+template<> struct ForwardCategory<ForwardFunctionDeclaration>	{ static const vint Tag = 1; };
+template<> struct ForwardCategory<ForwardEnumDeclaration>		{ static const vint Tag = 2; };
+template<> struct ForwardCategory<ForwardClassDeclaration>		{ static const vint Tag = 3; };
+
 template<typename TForward>
 struct ForwardPolicy
 {
+	static Ptr<Type> GetSignatureType(Symbol* symbol)
+	{
+		return nullptr;
+	}
+
 	static bool IsSameCategory(Symbol* symbol, Symbol* sibling)
 	{
 		return true;
@@ -19,62 +32,64 @@ struct ForwardPolicy
 template<>
 struct ForwardPolicy<ForwardFunctionDeclaration>
 {
-	static bool IsSameCategory(Symbol* symbol, Symbol* sibling)
+	static Ptr<Type> GetSignatureType(Symbol* symbol)
 	{
 		bool inClass = symbol->parent->decls.Count() > 0 && symbol->parent->decls[0].Cast<ClassDeclaration>();
 
-		auto f1 = symbol->decls[0].Cast<ForwardFunctionDeclaration>();
-		auto f2 = sibling->decls[0].Cast<ForwardFunctionDeclaration>();
-		auto t1 = f1->type;
-		auto t2 = f2->type;
-
+		auto type = symbol->decls[0].Cast<ForwardFunctionDeclaration>()->type;
 		if (inClass)
 		{
-			if (auto mt = t1.Cast<MemberType>())
+			if (auto mt = type.Cast<MemberType>())
 			{
-				t1 = mt->type;
-			}
-			if (auto mt = t2.Cast<MemberType>())
-			{
-				t2 = mt->type;
+				type = mt->type;
 			}
 		}
-		return IsSameResolvedType(t1, t2);
+		return type;
+	}
+
+	static bool IsSameCategory(Symbol* symbol, Symbol* sibling)
+	{
+		return IsSameResolvedType(GetSignatureType(symbol), GetSignatureType(sibling));
 	}
 };
 
 template<typename TForward>
 void SearchForwards(Symbol* scope, Symbol* symbol, Ptr<CppTokenCursor> cursor, Symbol*& root, List<Symbol*>& forwards)
 {
+	// every sibling must be a declaration of the same kind
+	// each one is checked against the first and the latest sibling when it is added, so checking them is enough
 	const auto& siblings = scope->children[symbol->name];
-	for (vint i = 0; i < siblings.Count(); i++)
+	vint latest = siblings[siblings.Count() - 1] == symbol ? siblings.Count() - 2 : siblings.Count() - 1;
+	if (!siblings[0]->decls[0].Cast<TForward>() || (latest > 0 && !siblings[latest]->decls[0].Cast<TForward>()))
 	{
-		auto& sibling = siblings[i];
-		bool sameCategory = ForwardPolicy<TForward>::IsSameCategory(symbol, sibling.Obj());
+		throw StopParsingException(cursor);
+	}
+
+	// only siblings of the same kind with the same signature hash could be in the same category
+	vint key = (vint)((Symbol::GetNameHash(symbol->name) * 31 + (vuint)HashResolvedType(ForwardPolicy<TForward>::GetSignatureType(symbol))) * 4 + ForwardCategory<TForward>::Tag);
+	scope->forwardSignatures.Add(key, symbol);
+	const auto& candidates = scope->forwardSignatures[key];
+
+	for (vint i = 0; i < candidates.Count(); i++)
+	{
+		auto sibling = candidates[i];
+		if (sibling->name != symbol->name) continue;
+		if (!ForwardPolicy<TForward>::IsSameCategory(symbol, sibling)) continue;
+
 		if (sibling->decls[0].Cast<typename TForward::ForwardRootType>())
 		{
-			if (sameCategory)
+			if (root)
 			{
-				if (root)
-				{
-					throw StopParsingException(cursor);
-				}
-				else
-				{
-					root = sibling.Obj();
-				}
+				throw StopParsingException(cursor);
 			}
-		}
-		else if (sibling->decls[0].Cast<TForward>())
-		{
-			if (sameCategory)
+			else
 			{
-				forwards.Add(sibling.Obj());
+				root = sibling;
 			}
 		}
 		else
 		{
-			throw StopParsingException(cursor);
+			forwards.Add(sibling);
 		}
 	}
 }
@@ -340,6 +355,9 @@ void ParseDeclaration(const ParsingArguments& pa, Ptr<CppTokenCursor>& cursor, L
 				}
 			}
 
+			// all base classes are complete now, members inherited from them could be cached
+			contextSymbol->classMemberCache = MakePtr<ClassMemberCache>();
+
 			// ... { { (public: | protected: | private: | DECLARATION) } };
 			RequireToken(cursor, CppTokens::LBRACE);
 			auto accessor = defaultAccessor;
@@ -375,6 +393,7 @@ void ParseDeclaration(const ParsingArguments& pa, Ptr<CppTokenCursor>& cursor, L
 				}
 			}
 
+			contextSymbol->isCompleteClass = true;
 			RequireToken(cursor, CppTokens::SEMICOLON);
 		}
 	}
@@ -402,9 +421,9 @@ void ParseDeclaration(const ParsingArguments& pa, Ptr<CppTokenCursor>& cursor, L
 					}
 				}
 
-				if (pa.context && !(pa.context->usingNss.Contains(symbol)))
+				if (pa.context)
 				{
-					pa.context->usingNss.Add(symbol);
+					pa.context->AddUsingNs(symbol);
 				}
 			}
 			else
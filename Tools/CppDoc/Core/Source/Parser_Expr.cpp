@@ -95,9 +95,9 @@ Ptr<IdExpr> ParseIdExpr(const ParsingArguments& pa, Ptr<CppTokenCursor>& cursor)
 			auto type = MakePtr<IdExpr>();
 			type->name = cppName;
 			type->resolving = rsr.values;
-			if (pa.recorder)
+			if (pa.unit->recorder)
 			{
-				pa.recorder->Index(type->name, type->resolving);
+				pa.unit->recorder->Index(type->name, type->resolving);
 			}
 			return type;
 		}
@@ -121,9 +121,9 @@ Ptr<ChildExpr> TryParseChildExpr(const ParsingArguments& pa, Ptr<Type> classType
 			type->classType = classType;
 			type->name = cppName;
 			type->resolving = rsr.values;
-			if (pa.recorder && type->resolving)
+			if (pa.unit->recorder && type->resolving)
 			{
-				pa.recorder->Index(type->name, type->resolving);
+				pa.unit->recorder->Index(type->name, type->resolving);
 			}
 			return type;
 		}
@@ -41,12 +41,14 @@ struct ResolveSymbolArguments
 	ResolveSymbolResult&		result;
 	bool&						found;
 	SortedList<Symbol*>&		searchedScopes;
+	vuint64_t					nameFilter;
 
 	ResolveSymbolArguments(CppName& _name, ResolveSymbolResult& _result, bool& _found, SortedList<Symbol*>& _searchedScopes)
 		:name(_name)
 		, result(_result)
 		, found(_found)
 		, searchedScopes(_searchedScopes)
+		, nameFilter(Symbol::GetNameFilter(_name.name))
 	{
 	}
 };
@@ -152,7 +154,113 @@ void AddSymbolToResolve(Ptr<Resolving>& resolving, Symbol* symbol)
 }
 
 /***********************************************************************
-ResolveChildSymbolInternal
+ResolveSymbolInChildren
+***********************************************************************/
+
+void ResolveSymbolInChildren(Symbol* scope, ResolveSymbolArguments& rsa)
+{
+	if (!scope->MayContainChild(rsa.nameFilter)) return;
+
+	vint index = scope->children.Keys().IndexOf(rsa.name.name);
+	if (index != -1)
+	{
+		const auto& symbols = scope->children.GetByIndex(index);
+		for (vint i = 0; i < symbols.Count(); i++)
+		{
+			auto symbol = symbols[i].Obj();
+			if (symbol->forwardDeclarationRoot)
+			{
+				symbol = symbol->forwardDeclarationRoot;
+			}
+
+			for (vint i = 0; i < symbol->decls.Count(); i++)
+			{
+				rsa.found = true;
+				if (IsPotentialTypeDecl(symbol->decls[i].Obj()))
+				{
+					AddSymbolToResolve(rsa.result.types, symbol);
+				}
+				else
+				{
+					AddSymbolToResolve(rsa.result.values, symbol);
+				}
+				break;
+			}
+		}
+	}
+}
+
+/***********************************************************************
+ResolveBaseSymbolInternal
+***********************************************************************/
+
+void AddMemoToResolve(ResolveSymbolResult& result, Ptr<Resolving> resolving)
+{
+	if (!resolving) return;
+	for (vint i = 0; i < resolving->resolvedSymbols.Count(); i++)
+	{
+		// a member may be connected to its definition after it is cached
+		auto symbol = resolving->resolvedSymbols[i];
+		if (symbol->forwardDeclarationRoot)
+		{
+			symbol = symbol->forwardDeclarationRoot;
+		}
+
+		if (symbol->decls.Count() > 0 && IsPotentialTypeDecl(symbol->decls[0].Obj()))
+		{
+			AddSymbolToResolve(result.types, symbol);
+		}
+		else
+		{
+			AddSymbolToResolve(result.values, symbol);
+		}
+	}
+}
+
+void ResolveBaseSymbolInternal(const ParsingArguments& pa, Symbol* scope, ClassDeclaration* decl, SearchPolicy childPolicy, ResolveSymbolArguments& rsa)
+{
+	auto cache = scope->classMemberCache;
+	if (!cache)
+	{
+		// base types are not completely parsed, the result cannot be cached
+		for (vint i = 0; i < decl->baseTypes.Count(); i++)
+		{
+			ResolveChildSymbolInternal(pa, decl->baseTypes[i].f1, childPolicy, rsa);
+		}
+		return;
+	}
+
+	auto& memos = childPolicy == SearchPolicy::ChildSymbol ? cache->inheritedMembers : cache->inheritedMembersFromSubClass;
+	Ptr<ResolveSymbolResult> memo;
+	vint index = memos.Keys().IndexOf(rsa.name.name);
+	if (index == -1)
+	{
+		memo = MakePtr<ResolveSymbolResult>();
+		bool found = false;
+		SortedList<Symbol*> searchedScopes;
+		searchedScopes.Add(scope);
+		ResolveSymbolArguments memoRsa(rsa.name, *memo.Obj(), found, searchedScopes);
+		for (vint i = 0; i < decl->baseTypes.Count(); i++)
+		{
+			ResolveChildSymbolInternal(pa, decl->baseTypes[i].f1, childPolicy, memoRsa);
+		}
+		memos.Add(rsa.name.name, memo);
+	}
+	else
+	{
+		memo = memos.Values()[index];
+	}
+
+	if (memo->types || memo->values)
+	{
+		rsa.found = true;
+		AddMemoToResolve(rsa.result, memo->types);
+		AddMemoToResolve(rsa.result, memo->values);
+	}
+}
+
+/***********************************************************************
+ResolveSymbolInternal
 ***********************************************************************/
 
 void ResolveSymbolInternal(const ParsingArguments& pa, SearchPolicy policy, ResolveSymbolArguments& rsa)
@@ -169,33 +277,7 @@ void ResolveSymbolInternal(const ParsingArguments& pa, SearchPolicy policy, Reso
 
 	while (scope)
 	{
-		vint index = scope->children.Keys().IndexOf(rsa.name.name);
-		if (index != -1)
-		{
-			const auto& symbols = scope->children.GetByIndex(index);
-			for (vint i = 0; i < symbols.Count(); i++)
-			{
-				auto symbol = symbols[i].Obj();
-				if (symbol->forwardDeclarationRoot)
-				{
-					symbol = symbol->forwardDeclarationRoot;
-				}
-
-				for (vint i = 0; i < symbol->decls.Count(); i++)
-				{
-					rsa.found = true;
-					if (IsPotentialTypeDecl(symbol->decls[i].Obj()))
-					{
-						AddSymbolToResolve(rsa.result.types, symbol);
-					}
-					else
-					{
-						AddSymbolToResolve(rsa.result.values, symbol);
-					}
-					break;
-				}
-			}
-		}
+		ResolveSymbolInChildren(scope, rsa);
 		if (rsa.found) break;
 
 		if (scope->decls.Count() > 0)
@@ -209,26 +291,28 @@ void ResolveSymbolInternal(const ParsingArguments& pa, SearchPolicy policy, Reso
 				}
 				else
 				{
-					for (vint i = 0; i < decl->baseTypes.Count(); i++)
-					{
-						auto childPolicy =
-							policy == SearchPolicy::ChildSymbol
-							? SearchPolicy::ChildSymbol
-							: SearchPolicy::ChildSymbolRequestedFromSubClass;
-						ResolveChildSymbolInternal(pa, decl->baseTypes[i].f1, childPolicy, rsa);
-					}
+					auto childPolicy =
+						policy == SearchPolicy::ChildSymbol
+						? SearchPolicy::ChildSymbol
+						: SearchPolicy::ChildSymbolRequestedFromSubClass;
+					ResolveBaseSymbolInternal(pa, scope, decl.Obj(), childPolicy, rsa);
 				}
 			}
 		}
 		if (rsa.found) break;
 
-		if (scope->usingNss.Count() > 0)
+		if (scope->usingNssClosure.Count() > 0)
 		{
-			for (vint i = 0; i < scope->usingNss.Count(); i++)
+			// names in a nominated namespace hide names in namespaces nominated by it
+			for (vint i = 0; i < scope->usingNssClosure.Count(); i++)
 			{
-				auto usingNs = scope->usingNss[i];
-				ParsingArguments newPa(pa, usingNs);
-				ResolveSymbolInternal(newPa, SearchPolicy::ChildSymbol, rsa);
+				if (rsa.found && scope->usingNssClosureDepths[i] != scope->usingNssClosureDepths[i - 1]) break;
+				auto usingNs = scope->usingNssClosure[i];
+				if (!rsa.searchedScopes.Contains(usingNs))
+				{
+					rsa.searchedScopes.Add(usingNs);
+					ResolveSymbolInChildren(usingNs, rsa);
+				}
 			}
 		}
 		if (rsa.found) break;
@@ -319,7 +403,7 @@ public:
 
 	void Visit(RootType* self)override
 	{
-		ResolveSymbolInternal({ pa,pa.root.Obj() }, SearchPolicy::ChildSymbol, rsa);
+		ResolveSymbolInternal({ pa,pa.unit->root.Obj() }, SearchPolicy::ChildSymbol, rsa);
 	}
 
 	void Visit(IdType* self)override
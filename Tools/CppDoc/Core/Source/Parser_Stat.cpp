@@ -30,6 +30,14 @@ void ParseVariableOrExpression(const ParsingArguments& pa, Ptr<CppTokenCursor>&
 	}
 }
 
+bool IsStatScopeReusable(Symbol* symbol)
+{
+	// if a statement introduces no name, its scope is shared with the next statement
+	if (symbol->usingNss.Count() > 0) return false;
+	const auto& names = symbol->children.Keys();
+	return names.Count() == 0 || (names.Count() == 1 && names[0] == L"$");
+}
+
 Ptr<Stat> ParseStat(const ParsingArguments& pa, Ptr<CppTokenCursor>& cursor)
 {
 	if (TestToken(cursor, CppTokens::SEMICOLON))
@@ -41,9 +49,14 @@ Ptr<Stat> ParseStat(const ParsingArguments& pa, Ptr<CppTokenCursor>& cursor)
 	{
 		// { { STATEMENT ...} }
 		auto stat = MakePtr<BlockStat>();
+		Symbol* statSymbol = nullptr;
 		while (!TestToken(cursor, CppTokens::RBRACE))
 		{
-			ParsingArguments newPa(pa, pa.context->CreateStatSymbol(stat));
+			if (!statSymbol || !IsStatScopeReusable(statSymbol))
+			{
+				statSymbol = pa.context->CreateStatSymbol(stat);
+			}
+			ParsingArguments newPa(pa, statSymbol);
 			stat->stats.Add(ParseStat(newPa, cursor));
 		}
 		return stat;
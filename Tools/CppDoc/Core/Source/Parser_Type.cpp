@@ -64,9 +64,9 @@ Ptr<IdType> ParseIdType(const ParsingArguments& pa, Ptr<CppTokenCursor>& cursor)
 			auto type = MakePtr<IdType>();
 			type->name = cppName;
 			type->resolving = resolving;
-			if (pa.recorder)
+			if (pa.unit->recorder)
 			{
-				pa.recorder->Index(type->name, type->resolving);
+				pa.unit->recorder->Index(type->name, type->resolving);
 			}
 			return type;
 		}
@@ -91,9 +91,9 @@ Ptr<ChildType> TryParseChildType(const ParsingArguments& pa, Ptr<Type> classType
 			type->typenameType = typenameType;
 			type->name = cppName;
 			type->resolving = resolving;
-			if (pa.recorder && type->resolving)
+			if (pa.unit->recorder && type->resolving)
 			{
-				pa.recorder->Index(type->name, type->resolving);
+				pa.unit->recorder->Index(type->name, type->resolving);
 			}
 			return type;
 		}
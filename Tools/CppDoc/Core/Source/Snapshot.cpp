@@ -0,0 +1,216 @@
+#include "Snapshot.h"
+
+/***********************************************************************
+PrefixSnapshot
+***********************************************************************/
+
+void PrefixSnapshot::Capture(Symbol* symbol)
+{
+	prefixSymbols.Add(symbol);
+
+	SymbolState state;
+	state.symbol = symbol;
+	state.childrenFilter = symbol->childrenFilter;
+	state.declCount = symbol->decls.Count();
+	state.forwardDeclarationRoot = symbol->forwardDeclarationRoot;
+	state.forwardDeclarationCount = symbol->forwardDeclarations.Count();
+	state.specializationRoot = symbol->specializationRoot;
+	state.specializationCount = symbol->specializations.Count();
+	state.usingNsCount = symbol->usingNss.Count();
+	state.usingNsReferrerCount = symbol->usingNssReferrers.Count();
+	state.hasResolvedTypes = symbol->resolvedTypes;
+	state.hasFunctionArity = symbol->functionArity.cached;
+	if (auto cache = symbol->classMemberCache)
+	{
+		state.inheritedMemberCount = cache->inheritedMembers.Count();
+		state.inheritedMemberFromSubClassCount = cache->inheritedMembersFromSubClass.Count();
+	}
+	states.Add(state);
+
+	for (vint i = 0; i < symbol->children.Count(); i++)
+	{
+		const auto& children = symbol->children.GetByIndex(i);
+		for (vint j = 0; j < children.Count(); j++)
+		{
+			Capture(children[j].Obj());
+		}
+	}
+}
+
+template<typename T>
+static void TruncateList(List<T>& list, vint count)
+{
+	if (list.Count() > count)
+	{
+		list.RemoveRange(count, list.Count() - count);
+	}
+}
+
+void PrefixSnapshot::Restore(PrefixParsingResult* result)
+{
+	for (vint i = 0; i < states.Count(); i++)
+	{
+		auto& state = states[i];
+		auto symbol = state.symbol;
+
+		// collect before removing, because an empty group key disappears
+		List<Ptr<Symbol>> addedChildren;
+		for (vint j = 0; j < symbol->children.Count(); j++)
+		{
+			const auto& children = symbol->children.GetByIndex(j);
+			for (vint k = 0; k < children.Count(); k++)
+			{
+				if (!prefixSymbols.Contains(children[k].Obj()))
+				{
+					addedChildren.Add(children[k]);
+				}
+			}
+		}
+		for (vint j = 0; j < addedChildren.Count(); j++)
+		{
+			auto child = addedChildren[j];
+			symbol->children.Remove(child->name, child.Obj());
+			result->symbols.Add(child);
+		}
+
+		List<Pair<vint, Symbol*>> addedSignatures;
+		for (vint j = 0; j < symbol->forwardSignatures.Count(); j++)
+		{
+			vint key = symbol->forwardSignatures.Keys()[j];
+			const auto& signatures = symbol->forwardSignatures.GetByIndex(j);
+			for (vint k = 0; k < signatures.Count(); k++)
+			{
+				if (!prefixSymbols.Contains(signatures[k]))
+				{
+					addedSignatures.Add({ key,signatures[k] });
+				}
+			}
+		}
+		for (vint j = 0; j < addedSignatures.Count(); j++)
+		{
+			symbol->forwardSignatures.Remove(addedSignatures[j].key, addedSignatures[j].value);
+		}
+
+		symbol->childrenFilter = state.childrenFilter;
+		symbol->forwardDeclarationRoot = state.forwardDeclarationRoot;
+		symbol->specializationRoot = state.specializationRoot;
+		TruncateList(symbol->decls, state.declCount);
+		TruncateList(symbol->forwardDeclarations, state.forwardDeclarationCount);
+		TruncateList(symbol->specializations, state.specializationCount);
+		TruncateList(symbol->usingNss, state.usingNsCount);
+		TruncateList(symbol->usingNssReferrers, state.usingNsReferrerCount);
+
+		// types resolved after the prefix are in the overlay
+		if (!state.hasResolvedTypes)
+		{
+			symbol->resolvedTypes = nullptr;
+		}
+
+		// arity is computed from decls, which could have been different after the prefix
+		if (!state.hasFunctionArity)
+		{
+			symbol->functionArity = SymbolFunctionArity();
+		}
+
+		// operator candidates are stamped with the generation, which is increased below, so they are all stale
+		symbol->operatorCandidateCache = nullptr;
+
+		// members of base classes searched after the prefix may be symbols created after the prefix
+		// memos are only added, so a different count means a memo is created after the prefix and all of them are dropped
+		if (auto cache = symbol->classMemberCache)
+		{
+			if (cache->inheritedMembers.Count() != state.inheritedMemberCount || cache->inheritedMembersFromSubClass.Count() != state.inheritedMemberFromSubClassCount)
+			{
+				cache->inheritedMembers.Clear();
+				cache->inheritedMembersFromSubClass.Clear();
+				state.inheritedMemberCount = 0;
+				state.inheritedMemberFromSubClassCount = 0;
+			}
+		}
+	}
+
+	// closures are rebuilt after all using directives are rolled back, because they read other scopes
+	for (vint i = 0; i < states.Count(); i++)
+	{
+		auto symbol = states[i].symbol;
+		if (symbol->usingNssClosure.Count() > 0)
+		{
+			symbol->BuildUsingNssClosure();
+		}
+	}
+
+	// all caches stamped before the rollback are discarded
+	pa.unit->root->generation++;
+}
+
+PrefixSnapshot::PrefixSnapshot(Ptr<RegexLexer> _lexer, const WString& _prefix, Ptr<ITsysAlloc> _tsys)
+	:lexer(_lexer)
+	, prefix(_prefix)
+	, tsys(_tsys)
+	, unit(new Symbol, _tsys, nullptr)
+	, pa(&unit)
+{
+	CppTokenReader reader(lexer, prefix);
+	auto cursor = reader.GetFirstToken();
+	program = ParseProgram(pa, cursor);
+	Capture(pa.unit->root.Obj());
+	tsys->Freeze();
+}
+
+const WString& PrefixSnapshot::GetPrefix()
+{
+	return prefix;
+}
+
+ParsingArguments& PrefixSnapshot::GetParsingArguments()
+{
+	return pa;
+}
+
+Ptr<Program> PrefixSnapshot::GetProgram()
+{
+	return program;
+}
+
+bool PrefixSnapshot::IsPrefixOf(const WString& input)
+{
+	return input.Length() >= prefix.Length() && input.Left(prefix.Length()) == prefix;
+}
+
+Ptr<PrefixParsingResult> PrefixSnapshot::Parse(const WString& input, Ptr<IIndexRecorder> recorder)
+{
+	CHECK_ERROR(IsPrefixOf(input), L"PrefixSnapshot::Parse(const WString&, Ptr<IIndexRecorder>)#The input does not begin with the prefix.");
+
+	// declarations after the prefix are indexed, tokens keep their positions in the whole input
+	CppTokenReader reader(lexer, input);
+	auto cursor = reader.GetFirstToken();
+	while (cursor && cursor->token.start < prefix.Length())
+	{
+		if (cursor->token.start + cursor->token.length > prefix.Length())
+		{
+			throw StopParsingException(cursor);
+		}
+		cursor = cursor->Next();
+	}
+
+	auto result = MakePtr<PrefixParsingResult>();
+	result->tsys = ITsysAlloc::CreateOverlay(tsys);
+	unit.SetTsys(result->tsys);
+	unit.SetRecorder(recorder);
+	try
+	{
+		result->program = ParseProgram(pa, cursor);
+	}
+	catch (...)
+	{
+		unit.SetTsys(tsys);
+		unit.SetRecorder(nullptr);
+		Restore(result.Obj());
+		throw;
+	}
+
+	unit.SetTsys(tsys);
+	unit.SetRecorder(nullptr);
+	Restore(result.Obj());
+	return result;
+}
@@ -0,0 +1,66 @@
+#ifndef VCZH_DOCUMENT_CPPDOC_SNAPSHOT
+#define VCZH_DOCUMENT_CPPDOC_SNAPSHOT
+
+#include "Parser.h"
+
+/***********************************************************************
+PrefixSnapshot
+***********************************************************************/
+
+// Everything created after the prefix, the program is valid as long as this object is alive
+class PrefixParsingResult : public Object
+{
+public:
+	Ptr<Program>				program;
+	Ptr<ITsysAlloc>				tsys;		// an overlay of the allocator for the prefix
+	List<Ptr<Symbol>>			symbols;	// symbols created after the prefix, removed from the symbol table
+};
+
+// Parses a common prefix once, inputs beginning with the same text resume parsing after it
+// Everything added to the symbol table after the prefix is rolled back when the input is done
+// Types for each input are created in an overlay, the allocator for the prefix is frozen and only keeps shared types
+// A snapshot is single-threaded, inputs modify and roll back its symbol table in place, so they are parsed one at a time
+class PrefixSnapshot : public Object
+{
+protected:
+	struct SymbolState
+	{
+		Symbol*					symbol = nullptr;
+		vuint64_t				childrenFilter = 0;
+		vint					declCount = 0;
+		Symbol*					forwardDeclarationRoot = nullptr;
+		vint					forwardDeclarationCount = 0;
+		Symbol*					specializationRoot = nullptr;
+		vint					specializationCount = 0;
+		vint					usingNsCount = 0;
+		vint					usingNsReferrerCount = 0;
+		bool					hasResolvedTypes = false;
+		bool					hasFunctionArity = false;
+		vint					inheritedMemberCount = 0;
+		vint					inheritedMemberFromSubClassCount = 0;
+	};
+
+	Ptr<RegexLexer>				lexer;
+	WString						prefix;
+	Ptr<ITsysAlloc>				tsys;
+	ParsingUnit					unit;
+	ParsingArguments			pa;
+	Ptr<Program>				program;
+
+	SortedList<Symbol*>			prefixSymbols;
+	List<SymbolState>			states;
+
+	void						Capture(Symbol* symbol);
+	void						Restore(PrefixParsingResult* result);
+public:
+	PrefixSnapshot(Ptr<RegexLexer> _lexer, const WString& _prefix, Ptr<ITsysAlloc> _tsys);
+
+	const WString&				GetPrefix();
+	ParsingArguments&			GetParsingArguments();
+	Ptr<Program>				GetProgram();
+
+	bool						IsPrefixOf(const WString& input);
+	Ptr<PrefixParsingResult>	Parse(const WString& input, Ptr<IIndexRecorder> recorder);
+};
+
+#endif
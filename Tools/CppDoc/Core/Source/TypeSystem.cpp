@@ -1,84 +1,53 @@
 #include "TypeSystem.h"
 
 class TsysAlloc;
+struct TsysInternKey;
 
 #define DEFINE_TSYS_TYPE(NAME) class ITsys_##NAME;
 TSYS_TYPE_LIST(DEFINE_TSYS_TYPE)
 #undef DEFINE_TSYS_TYPE
 
-template<typename T, vint BlockSize>
-class ITsys_Allocator;
-
 /***********************************************************************
 TsysBase
 ***********************************************************************/
 
-template<typename TType, typename TData>
-struct WithParams
-{
-	IEnumerable<ITsys*>*	params;
-	TType*					itsys;
-	TData					data;
-
-	static vint Compare(WithParams<TType, TData> a, WithParams<TType, TData> b)
-	{
-		vint result = TData::Compare(a.data, b.data);
-		if (result != 0) return result;
-		return CompareEnumerable(*a.params, *b.params);
-	}
-};
-#define OPERATOR_COMPARE(OP)\
-	template<typename TType, typename TData>\
-	bool operator OP(WithParams<TType, TData> a, WithParams<TType, TData> b)\
-	{\
-		return WithParams<TType, TData>::Compare(a, b) OP 0;\
-	}\
-
-OPERATOR_COMPARE(>)
-OPERATOR_COMPARE(>=)
-OPERATOR_COMPARE(<)
-OPERATOR_COMPARE(<=)
-OPERATOR_COMPARE(==)
-OPERATOR_COMPARE(!=)
-#undef OPERATOR_COMPARE
-
-namespace vl
-{
-	template<typename TType, typename TData>
-	struct POD<WithParams<TType, TData>>
-	{
-		static const bool Result = true;
-	};
-}
-
 class TsysBase : public ITsys
 {
-	template<typename TType, typename TData>
-	using WithParamsList = SortedList<WithParams<TType, TData>>;
-
 #define DEFINE_TSYS_TYPE(NAME) friend class ITsys_##NAME;
 	TSYS_TYPE_LIST(DEFINE_TSYS_TYPE)
 #undef DEFINE_TSYS_TYPE
 protected:
 	TsysAlloc*										tsys;
+	vint											id;
 	ITsys_LRef*										lrefOf = nullptr;
 	ITsys_RRef*										rrefOf = nullptr;
 	ITsys_Ptr*										ptrOf = nullptr;
-	Dictionary<vint, ITsys_Array*>					arrayOf;
-	Dictionary<ITsys*, ITsys_Member*>				memberOf;
 	ITsys_CV*										cvOf[3] = { 0 };
-	WithParamsList<ITsys_Function, TsysFunc>		functionOf;
-	WithParamsList<ITsys_Generic, TsysGeneric>		genericOf;
 
-	template<typename TType, typename TData, vint BlockSize>
-	ITsys* ParamsOf(IEnumerable<ITsys*>& params, const TData& data, WithParamsList<TType, TData>& paramsOf, ITsys_Allocator<TType, BlockSize> TsysAlloc::* alloc);
+	// GetEntity is precomputed when a type is created, since the element never changes
+	TsysBase*										entity = this;
+	TsysCV											entityCV;
+	TsysRefType										entityRef = TsysRefType::None;
 
-	virtual ITsys* GetEntityInternal(TsysCV& cv, TsysRefType& refType)
+	virtual TsysBase* GetEntityInternal(TsysCV& cv, TsysRefType& refType)
 	{
 		return this;
 	}
+
+	void DecomposeEntity()
+	{
+		entity = GetEntityInternal(entityCV, entityRef);
+	}
+
+	static TsysAlloc* SelectAlloc(TsysAlloc* tsys, ITsys* part);
+	TsysAlloc* GetActiveOverlay();
+
+	template<typename TCreate>
+	ITsys* InternInOverlay(const TsysInternKey& key, const TCreate& create);
 public:
-	TsysBase(TsysAlloc* _tsys) :tsys(_tsys) {}
+	TsysBase(TsysAlloc* _tsys);
+
+	vint				GetId()override								{ return id; }
 
 	TsysPrimitive		GetPrimitive()								{ throw "Not Implemented!"; }
 	TsysCV				GetCV()										{ throw "Not Implemented!"; }
@@ -101,9 +70,9 @@ public:
 
 	ITsys* GetEntity(TsysCV& cv, TsysRefType& refType)override
 	{
-		cv = { false,false };
-		refType = TsysRefType::None;
-		return GetEntityInternal(cv, refType);
+		cv = entityCV;
+		refType = entityRef;
+		return entity;
 	}
 };
 
@@ -137,7 +106,8 @@ Concrete Tsys
 	protected:																						\
 		TsysBase*			element;																\
 	public:																							\
-		ITsys_##TYPE(TsysAlloc* _tsys, TsysBase* _element) :TsysBase_(_tsys), element(_element) {}	\
+		ITsys_##TYPE(TsysAlloc* _tsys, TsysBase* _element)											\
+			:TsysBase_(_tsys), element(_element) { DecomposeEntity(); }								\
 		ITsys* GetElement()override { return element; }												\
 
 #define ITSYS_MEMBERS_DECORATE(TYPE, DATA, NAME)													\
@@ -146,7 +116,7 @@ Concrete Tsys
 		DATA				data;																	\
 	public:																							\
 		ITsys_##TYPE(TsysAlloc* _tsys, TsysBase* _element, DATA _data)								\
-			:TsysBase_(_tsys), element(_element), data(_data) {}									\
+			:TsysBase_(_tsys), element(_element), data(_data) { DecomposeEntity(); }				\
 		ITsys* GetElement()override { return element; }												\
 		DATA Get##NAME()override { return data; }													\
 
@@ -238,7 +208,7 @@ class ITSYS_CLASS(LRef)
 		return this;
 	}
 protected:
-	ITsys* GetEntityInternal(TsysCV& cv, TsysRefType& refType)override
+	TsysBase* GetEntityInternal(TsysCV& cv, TsysRefType& refType)override
 	{
 		refType = TsysRefType::LRef;
 		return element->GetEntityInternal(cv, refType);
@@ -264,7 +234,7 @@ class ITSYS_CLASS(RRef)
 		return this;
 	}
 protected:
-	ITsys* GetEntityInternal(TsysCV& cv, TsysRefType& refType)override
+	TsysBase* GetEntityInternal(TsysCV& cv, TsysRefType& refType)override
 	{
 		refType = TsysRefType::RRef;
 		return element->GetEntityInternal(cv, refType);
@@ -292,7 +262,7 @@ class ITSYS_CLASS(CV)
 		return element->CVOf(cv);
 	}
 protected:
-	ITsys* GetEntityInternal(TsysCV& cv, TsysRefType& refType)override
+	TsysBase* GetEntityInternal(TsysCV& cv, TsysRefType& refType)override
 	{
 		cv = data;
 		return element->GetEntityInternal(cv, refType);
@@ -330,6 +300,301 @@ public:
 	}
 };
 
+/***********************************************************************
+TsysInternTable
+***********************************************************************/
+
+struct TsysInternKey
+{
+	TsysType				type;
+	ITsys*					element;
+	vint					data;		// dimensions for Array, class for Member, calling convention and ellipsis for Function, cv for CV
+	IEnumerable<ITsys*>*	params;
+	vuint					hash;
+
+	TsysInternKey(TsysType _type, ITsys* _element, vint _data, IEnumerable<ITsys*>* _params = nullptr)
+		:type(_type)
+		, element(_element)
+		, data(_data)
+		, params(_params)
+	{
+		hash = (vuint)type;
+		hash = hash * 31 + (vuint)element;
+		hash = hash * 31 + (vuint)data;
+		if (params)
+		{
+			Ptr<IEnumerator<ITsys*>> enumerator = params->CreateEnumerator();
+			while (enumerator->Next())
+			{
+				hash = hash * 31 + (vuint)enumerator->Current();
+			}
+		}
+		hash ^= hash >> 16;
+	}
+
+	static vint PackFunc(TsysFunc func)
+	{
+		return (vint)func.callingConvention * 2 + (func.ellipsis ? 1 : 0);
+	}
+
+	static vint PackCV(TsysCV cv)
+	{
+		return (cv.isGeneralConst ? 2 : 0) + (cv.isVolatile ? 1 : 0);
+	}
+
+	bool Match(ITsys* itsys)const
+	{
+		if (itsys->GetType() != type) return false;
+		if (itsys->GetElement() != element) return false;
+		switch (type)
+		{
+		case TsysType::LRef:
+		case TsysType::RRef:
+		case TsysType::Ptr:
+			return true;
+		case TsysType::CV:
+			return PackCV(itsys->GetCV()) == data;
+		case TsysType::Array:
+			return itsys->GetParamCount() == data;
+		case TsysType::Member:
+			return (vint)itsys->GetClass() == data;
+		case TsysType::Function:
+			return PackFunc(itsys->GetFunc()) == data && CompareEnumerable(*params, static_cast<ITsys_Function*>(itsys)->GetParams()) == 0;
+		case TsysType::Generic:
+			return CompareEnumerable(*params, static_cast<ITsys_Generic*>(itsys)->GetParams()) == 0;
+		default:
+			return false;
+		}
+	}
+};
+
+// Open addressing hash table for all types that are created from an element and extra data
+class TsysInternTable : public Object
+{
+protected:
+	struct Entry
+	{
+		vuint				hash = 0;
+		ITsys*				itsys = nullptr;
+	};
+
+	Array<Entry>			entries;
+	vint					count = 0;
+
+	void Rehash(vint capacity)
+	{
+		Array<Entry> oldEntries;
+		CopyFrom(oldEntries, entries);
+		entries.Resize(capacity);
+		for (vint i = 0; i < entries.Count(); i++)
+		{
+			entries[i] = Entry();
+		}
+
+		for (vint i = 0; i < oldEntries.Count(); i++)
+		{
+			auto& entry = oldEntries[i];
+			if (entry.itsys)
+			{
+				entries[Probe(entry.hash, nullptr)] = entry;
+			}
+		}
+	}
+
+	vint Probe(vuint hash, const TsysInternKey* key)
+	{
+		vuint mask = (vuint)entries.Count() - 1;
+		vuint index = hash & mask;
+		while (true)
+		{
+			auto& entry = entries[(vint)index];
+			if (!entry.itsys) return (vint)index;
+			if (key && entry.hash == hash && key->Match(entry.itsys)) return (vint)index;
+			index = (index + 1) & mask;
+		}
+	}
+public:
+	TsysInternTable()
+		:entries(256)
+	{
+	}
+
+	ITsys* Find(const TsysInternKey& key)
+	{
+		return entries[Probe(key.hash, &key)].itsys;
+	}
+
+	void Add(const TsysInternKey& key, ITsys* itsys)
+	{
+		if ((count + 1) * 2 > entries.Count())
+		{
+			Rehash(entries.Count() * 2);
+		}
+		auto& entry = entries[Probe(key.hash, nullptr)];
+		entry.hash = key.hash;
+		entry.itsys = itsys;
+		count++;
+	}
+};
+
+/***********************************************************************
+TsysConvCache
+***********************************************************************/
+
+// Open addressing hash table for TestConvert results, keyed by ids of both types
+class TsysConvCache : public Object
+{
+protected:
+	struct Entry
+	{
+		vuint64_t			key = 0;	// 0 means empty, ids are stored plus one
+		TsysConv			conv = TsysConv::Illegal;
+	};
+
+	Array<Entry>			entries;
+	vint					count = 0;
+
+	static vuint64_t GetKey(ITsys* toType, ITsys* fromType)
+	{
+		return ((vuint64_t)(toType->GetId() + 1) << 32) | (vuint64_t)(fromType->GetId() + 1);
+	}
+
+	vint Probe(vuint64_t key)
+	{
+		vuint mask = (vuint)entries.Count() - 1;
+		vuint index = (vuint)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+		while (true)
+		{
+			auto& entry = entries[(vint)index];
+			if (entry.key == 0 || entry.key == key) return (vint)index;
+			index = (index + 1) & mask;
+		}
+	}
+public:
+	TsysCacheStatistics		statistics;
+
+	TsysConvCache()
+		:entries(256)
+	{
+	}
+
+	bool Get(ITsys* toType, ITsys* fromType, TsysConv& conv)
+	{
+		auto key = GetKey(toType, fromType);
+		auto& entry = entries[Probe(key)];
+		if (entry.key == 0)
+		{
+			statistics.misses++;
+			return false;
+		}
+		statistics.hits++;
+		conv = entry.conv;
+		return true;
+	}
+
+	void Set(ITsys* toType, ITsys* fromType, TsysConv conv)
+	{
+		if ((count + 1) * 2 > entries.Count())
+		{
+			Array<Entry> oldEntries;
+			CopyFrom(oldEntries, entries);
+			entries.Resize(entries.Count() * 2);
+			for (vint i = 0; i < entries.Count(); i++)
+			{
+				entries[i] = Entry();
+			}
+			for (vint i = 0; i < oldEntries.Count(); i++)
+			{
+				if (oldEntries[i].key != 0)
+				{
+					entries[Probe(oldEntries[i].key)] = oldEntries[i];
+				}
+			}
+		}
+
+		auto key = GetKey(toType, fromType);
+		auto& entry = entries[Probe(key)];
+		if (entry.key == 0) count++;
+		entry.key = key;
+		entry.conv = conv;
+	}
+};
+
+/***********************************************************************
+TsysOverloadCache
+***********************************************************************/
+
+class TsysOverloadCache : public Object
+{
+protected:
+	struct Entry
+	{
+		Array<vint>			signature;
+		vint				generation = 0;
+		List<ITsys*>		selected;
+	};
+
+	Group<vint, Ptr<Entry>>	entries;	// indexed by hash of signatures
+
+	static vint GetHash(const Array<vint>& signature)
+	{
+		vuint hash = 0;
+		for (vint i = 0; i < signature.Count(); i++)
+		{
+			hash = hash * 31 + (vuint)signature[i];
+		}
+		return (vint)hash;
+	}
+
+	Ptr<Entry> Find(vint hash, const Array<vint>& signature)
+	{
+		vint index = entries.Keys().IndexOf(hash);
+		if (index == -1) return nullptr;
+
+		auto& bucket = entries.GetByIndex(index);
+		for (vint i = 0; i < bucket.Count(); i++)
+		{
+			auto entry = bucket[i];
+			if (CompareEnumerable(entry->signature, signature) == 0)
+			{
+				return entry;
+			}
+		}
+		return nullptr;
+	}
+public:
+	TsysCacheStatistics		statistics;
+
+	bool Get(const Array<vint>& signature, vint generation, List<ITsys*>& selected)
+	{
+		auto entry = Find(GetHash(signature), signature);
+		if (!entry || entry->generation != generation)
+		{
+			statistics.misses++;
+			return false;
+		}
+		statistics.hits++;
+		CopyFrom(selected, entry->selected);
+		return true;
+	}
+
+	void Set(const Array<vint>& signature, vint generation, const List<ITsys*>& selected)
+	{
+		vint hash = GetHash(signature);
+		auto entry = Find(hash, signature);
+		if (!entry)
+		{
+			entry = MakePtr<Entry>();
+			CopyFrom(entry->signature, signature);
+			entries.Add(hash, entry);
+		}
+
+		// a stale entry is replaced, symbols in its signature may have been freed and their addresses reused
+		entry->generation = generation;
+		CopyFrom(entry->selected, selected);
+	}
+};
+
 /***********************************************************************
 ITsys_Allocator
 ***********************************************************************/
@@ -398,9 +663,18 @@ public:
 ITsysAlloc
 ***********************************************************************/
 
+// ids in an overlay start from here, so that they never collide with ids in the base
+static const vint									OverlayIdOffset = (vint)1 << 30;
+
 class TsysAlloc : public Object, public ITsysAlloc
 {
+	friend class TsysBase;
 protected:
+	Ptr<ITsysAlloc>									baseOwner;		// the following fields must be initialized before tsysZero and tsysNullptr
+	TsysAlloc*										base = nullptr;
+	vint											idOffset = 0;
+	bool											frozen = false;	// the base of any overlay is read-only
+	List<ITsys*>									tsysById;
 	ITsys_Zero										tsysZero;
 	ITsys_Nullptr									tsysNullptr;
 	ITsys_Primitive*								primitives[(vint)TsysPrimitiveType::_COUNT * (vint)TsysBytes::_COUNT] = { 0 };
@@ -408,6 +682,10 @@ protected:
 	Dictionary<Symbol*, ITsys_GenericArg*>			genericArgs;
 
 public:
+	TsysInternTable									interned;
+	TsysConvCache									convs;
+	TsysOverloadCache								overloads;
+
 	ITsys_Allocator<ITsys_Primitive,	1024>		_primitive;
 	ITsys_Allocator<ITsys_LRef,			1024>		_lref;
 	ITsys_Allocator<ITsys_RRef,			1024>		_rref;
@@ -421,20 +699,90 @@ public:
 	ITsys_Allocator<ITsys_GenericArg,	1024>		_genericArg;
 	ITsys_Allocator<ITsys_Expr,			1024>		_expr;
 
-	TsysAlloc()
-		:tsysZero(this)
+	TsysAlloc(Ptr<ITsysAlloc> _base)
+		:baseOwner(_base)
+		, base(_base.Cast<TsysAlloc>().Obj())
+		, idOffset(_base ? OverlayIdOffset : 0)
+		, tsysZero(this)
 		, tsysNullptr(this)
 	{
+		if (base)
+		{
+			CHECK_ERROR(!base->base, L"ITsysAlloc::CreateOverlay(Ptr<ITsysAlloc>)#The base cannot be an overlay.");
+			CHECK_ERROR(base->frozen, L"ITsysAlloc::CreateOverlay(Ptr<ITsysAlloc>)#The base must be frozen before creating overlays.");
+		}
+	}
+
+	void Freeze()override
+	{
+		CHECK_ERROR(!base, L"TsysAlloc::Freeze()#An overlay cannot be frozen.");
+		frozen = true;
+	}
+
+	bool IsOverlay()override
+	{
+		return base != nullptr;
+	}
+
+	vint RegisterTsys(ITsys* itsys)
+	{
+		tsysById.Add(itsys);
+		return idOffset + tsysById.Count() - 1;
+	}
+
+	vint GetTsysCount()override
+	{
+		// only types created in this allocator
+		return tsysById.Count();
+	}
+
+	ITsys* GetTsysById(vint id)override
+	{
+		if (id < idOffset)
+		{
+			return base->GetTsysById(id);
+		}
+		return tsysById[id - idOffset];
+	}
+
+	bool GetCachedConv(ITsys* toType, ITsys* fromType, TsysConv& conv)override
+	{
+		return convs.Get(toType, fromType, conv);
+	}
+
+	void SetCachedConv(ITsys* toType, ITsys* fromType, TsysConv conv)override
+	{
+		convs.Set(toType, fromType, conv);
+	}
+
+	TsysCacheStatistics GetConvCacheStatistics()override
+	{
+		return convs.statistics;
+	}
+
+	bool GetCachedOverload(const Array<vint>& signature, vint generation, List<ITsys*>& selected)override
+	{
+		return overloads.Get(signature, generation, selected);
+	}
+
+	void SetCachedOverload(const Array<vint>& signature, vint generation, const List<ITsys*>& selected)override
+	{
+		overloads.Set(signature, generation, selected);
+	}
+
+	TsysCacheStatistics GetOverloadCacheStatistics()override
+	{
+		return overloads.statistics;
 	}
 
 	ITsys* Zero()override
 	{
-		return &tsysZero;
+		return base ? base->Zero() : &tsysZero;
 	}
 
 	ITsys* Nullptr()override
 	{
-		return &tsysNullptr;
+		return base ? base->Nullptr() : &tsysNullptr;
 	}
 
 	ITsys* Int()override
@@ -462,9 +810,11 @@ public:
 		vint index = (vint)TsysBytes::_COUNT * a + b;
 		if (index > sizeof(primitives) / sizeof(*primitives)) throw "Not Implemented!";
 
+		if (base && base->primitives[index]) return base->primitives[index];
 		auto& itsys = primitives[index];
 		if (!itsys)
 		{
+			CHECK_ERROR(!frozen, L"TsysAlloc::PrimitiveOf(TsysPrimitive)#The allocator is the base of an overlay.");
 			itsys = _primitive.Alloc(this, primitive);
 		}
 		return itsys;
@@ -472,8 +822,15 @@ public:
 
 	ITsys* DeclOf(Symbol* decl)override
 	{
+		if (base)
+		{
+			vint index = base->decls.Keys().IndexOf(decl);
+			if (index != -1) return base->decls.Values()[index];
+		}
+
 		vint index = decls.Keys().IndexOf(decl);
 		if (index != -1) return decls.Values()[index];
+		CHECK_ERROR(!frozen, L"TsysAlloc::DeclOf(Symbol*)#The allocator is the base of an overlay.");
 		auto itsys = _decl.Alloc(this, decl);
 		decls.Add(decl, itsys);
 		return itsys;
@@ -481,8 +838,15 @@ public:
 
 	ITsys* GenericArgOf(Symbol* decl)override
 	{
+		if (base)
+		{
+			vint index = base->genericArgs.Keys().IndexOf(decl);
+			if (index != -1) return base->genericArgs.Values()[index];
+		}
+
 		vint index = genericArgs.Keys().IndexOf(decl);
 		if (index != -1) return genericArgs.Values()[index];
+		CHECK_ERROR(!frozen, L"TsysAlloc::GenericArgOf(Symbol*)#The allocator is the base of an overlay.");
 		auto itsys = _genericArg.Alloc(this, decl);
 		genericArgs.Add(decl, itsys);
 		return itsys;
@@ -491,69 +855,130 @@ public:
 
 Ptr<ITsysAlloc> ITsysAlloc::Create()
 {
-	return new TsysAlloc;
+	return new TsysAlloc(nullptr);
+}
+
+Ptr<ITsysAlloc> ITsysAlloc::CreateOverlay(Ptr<ITsysAlloc> base)
+{
+	return new TsysAlloc(base);
+}
+
+/***********************************************************************
+TsysOverlayScope
+***********************************************************************/
+
+static ThreadVariable<TsysAlloc*>					activeOverlay;
+
+TsysOverlayScope::TsysOverlayScope(Ptr<ITsysAlloc> overlay)
+	:previous(activeOverlay.Get())
+{
+	auto tsys = overlay.Cast<TsysAlloc>().Obj();
+	CHECK_ERROR(tsys && tsys->IsOverlay(), L"TsysOverlayScope::TsysOverlayScope(Ptr<ITsysAlloc>)#The allocator is not an overlay.");
+	activeOverlay.Set(tsys);
+}
+
+TsysOverlayScope::~TsysOverlayScope()
+{
+	activeOverlay.Set(static_cast<TsysAlloc*>(previous));
 }
 
 /***********************************************************************
 TsysBase (Impl)
 ***********************************************************************/
 
-template<typename TType, typename TData, vint BlockSize>
-ITsys* TsysBase::ParamsOf(IEnumerable<ITsys*>& params, const TData& data, WithParamsList<TType, TData>& paramsOf, ITsys_Allocator<TType, BlockSize> TsysAlloc::* alloc)
+TsysBase::TsysBase(TsysAlloc* _tsys)
+	:tsys(_tsys)
+	, id(_tsys->RegisterTsys(this))
 {
-	WithParams<TType, TData> key;
-	key.params = &params;
-	key.itsys = nullptr;
-	key.data = data;
-	vint index = paramsOf.IndexOf(key);
-	if (index != -1) return paramsOf[index].itsys;
+}
 
-	auto itsys = (tsys->*alloc).Alloc(tsys, this, data);
-	CopyFrom(itsys->GetParams(), params);
-	key.params = &itsys->GetParams();
-	key.itsys = itsys;
-	paramsOf.Add(key);
+TsysAlloc* TsysBase::SelectAlloc(TsysAlloc* tsys, ITsys* part)
+{
+	// a type belongs to an overlay if any part of it does
+	auto partTsys = static_cast<TsysBase*>(part)->tsys;
+	return partTsys->base ? partTsys : tsys;
+}
+
+TsysAlloc* TsysBase::GetActiveOverlay()
+{
+	auto overlay = activeOverlay.Get();
+	CHECK_ERROR(overlay && overlay->base == tsys, L"TsysBase::GetActiveOverlay()#The allocator is the base of an overlay, but none of its overlays is activated.");
+	return overlay;
+}
+
+template<typename TCreate>
+ITsys* TsysBase::InternInOverlay(const TsysInternKey& key, const TCreate& create)
+{
+	// a frozen base is read-only, new types made of its types are interned in the overlay instead of memo slots
+	auto overlay = GetActiveOverlay();
+	if (auto itsys = overlay->interned.Find(key)) return itsys;
+	ITsys* itsys = create(overlay);
+	overlay->interned.Add(key, itsys);
 	return itsys;
 }
 
 ITsys* TsysBase::LRefOf()
 {
-	if (!lrefOf) lrefOf = tsys->_lref.Alloc(tsys, this);
+	if (lrefOf) return lrefOf;
+	if (tsys->frozen) return InternInOverlay(TsysInternKey(TsysType::LRef, this, 0), [this](TsysAlloc* owner) { return owner->_lref.Alloc(owner, this); });
+	lrefOf = tsys->_lref.Alloc(tsys, this);
 	return lrefOf;
 }
 
 ITsys* TsysBase::RRefOf()
 {
-	if (!rrefOf) rrefOf = tsys->_rref.Alloc(tsys, this);
+	if (rrefOf) return rrefOf;
+	if (tsys->frozen) return InternInOverlay(TsysInternKey(TsysType::RRef, this, 0), [this](TsysAlloc* owner) { return owner->_rref.Alloc(owner, this); });
+	rrefOf = tsys->_rref.Alloc(tsys, this);
 	return rrefOf;
 }
 
 ITsys* TsysBase::PtrOf()
 {
-	if (!ptrOf) ptrOf = tsys->_ptr.Alloc(tsys, this);
+	if (ptrOf) return ptrOf;
+	if (tsys->frozen) return InternInOverlay(TsysInternKey(TsysType::Ptr, this, 0), [this](TsysAlloc* owner) { return owner->_ptr.Alloc(owner, this); });
+	ptrOf = tsys->_ptr.Alloc(tsys, this);
 	return ptrOf;
 }
 
 ITsys* TsysBase::ArrayOf(vint dimensions)
 {
-	vint index = arrayOf.Keys().IndexOf(dimensions);
-	if (index != -1) return arrayOf.Values()[index];
+	TsysInternKey key(TsysType::Array, this, dimensions);
+	if (auto itsys = tsys->interned.Find(key)) return itsys;
+	if (tsys->frozen) return InternInOverlay(key, [=](TsysAlloc* owner) { return owner->_array.Alloc(owner, this, dimensions); });
 	auto itsys = tsys->_array.Alloc(tsys, this, dimensions);
-	arrayOf.Add(dimensions, itsys);
+	tsys->interned.Add(key, itsys);
 	return itsys;
 }
 
 ITsys* TsysBase::FunctionOf(IEnumerable<ITsys*>& params, TsysFunc func)
 {
-	return ParamsOf(params, func, functionOf, &TsysAlloc::_function);
+	auto owner = tsys;
+	Ptr<IEnumerator<ITsys*>> enumerator = params.CreateEnumerator();
+	while (enumerator->Next())
+	{
+		owner = SelectAlloc(owner, enumerator->Current());
+	}
+
+	TsysInternKey key(TsysType::Function, this, TsysInternKey::PackFunc(func), &params);
+	if (auto itsys = owner->interned.Find(key)) return itsys;
+	if (owner->frozen) owner = GetActiveOverlay();
+	if (auto itsys = owner->interned.Find(key)) return itsys;
+	auto itsys = owner->_function.Alloc(owner, this, func);
+	CopyFrom(itsys->GetParams(), params);
+	owner->interned.Add(key, itsys);
+	return itsys;
 }
 
 ITsys* TsysBase::MemberOf(ITsys* classType)
 {
-	vint index = memberOf.Keys().IndexOf(classType);
-	if (index != -1) return memberOf.Values()[index];
-	auto itsys = tsys->_member.Alloc(tsys, this, classType);
-	memberOf.Add(classType, itsys);
+	auto owner = SelectAlloc(tsys, classType);
+	TsysInternKey key(TsysType::Member, this, (vint)classType);
+	if (auto itsys = owner->interned.Find(key)) return itsys;
+	if (owner->frozen) owner = GetActiveOverlay();
+	if (auto itsys = owner->interned.Find(key)) return itsys;
+	auto itsys = owner->_member.Alloc(owner, this, classType);
+	owner->interned.Add(key, itsys);
 	return itsys;
 }
 
@@ -572,11 +997,27 @@ ITsys* TsysBase::CVOf(TsysCV cv)
 
 	if (index > sizeof(cvOf) / sizeof(*cvOf)) throw "Not Implemented!";
 	auto& itsys = cvOf[index];
-	if (!itsys) itsys = tsys->_cv.Alloc(tsys, this, cv);
+	if (itsys) return itsys;
+	if (tsys->frozen) return InternInOverlay(TsysInternKey(TsysType::CV, this, TsysInternKey::PackCV(cv)), [=](TsysAlloc* owner) { return owner->_cv.Alloc(owner, this, cv); });
+	itsys = tsys->_cv.Alloc(tsys, this, cv);
 	return itsys;
 }
 
 ITsys* TsysBase::GenericOf(IEnumerable<ITsys*>& params)
 {
-	return ParamsOf(params, TsysGeneric(), genericOf, &TsysAlloc::_generic);
+	auto owner = tsys;
+	Ptr<IEnumerator<ITsys*>> enumerator = params.CreateEnumerator();
+	while (enumerator->Next())
+	{
+		owner = SelectAlloc(owner, enumerator->Current());
+	}
+
+	TsysInternKey key(TsysType::Generic, this, 0, &params);
+	if (auto itsys = owner->interned.Find(key)) return itsys;
+	if (owner->frozen) owner = GetActiveOverlay();
+	if (auto itsys = owner->interned.Find(key)) return itsys;
+	auto itsys = owner->_generic.Alloc(owner, this, TsysGeneric());
+	CopyFrom(itsys->GetParams(), params);
+	owner->interned.Add(key, itsys);
+	return itsys;
 }
\ No newline at end of file
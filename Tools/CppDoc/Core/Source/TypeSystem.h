@@ -132,6 +132,7 @@ enum class TsysConv
 class ITsys abstract : public Interface
 {
 public:
+	virtual vint				GetId() = 0;
 	virtual TsysType			GetType() = 0;
 	virtual TsysPrimitive		GetPrimitive() = 0;
 	virtual TsysCV				GetCV() = 0;
@@ -159,9 +160,19 @@ public:
 ITsysAlloc
 ***********************************************************************/
 
+struct TsysCacheStatistics
+{
+	vint						hits = 0;
+	vint						misses = 0;
+};
+
+// An allocator is not thread-safe, each translation unit being parsed in parallel owns its allocator
 class ITsysAlloc abstract : public Interface
 {
 public:
+	virtual vint				GetTsysCount() = 0;
+	virtual ITsys*				GetTsysById(vint id) = 0;
+
 	virtual ITsys*				Zero() = 0;
 	virtual ITsys*				Nullptr() = 0;
 	virtual ITsys*				Int() = 0;
@@ -172,7 +183,35 @@ public:
 	virtual ITsys*				DeclOf(Symbol* decl) = 0;
 	virtual ITsys*				GenericArgOf(Symbol* decl) = 0;
 
+	virtual bool				GetCachedConv(ITsys* toType, ITsys* fromType, TsysConv& conv) = 0;
+	virtual void				SetCachedConv(ITsys* toType, ITsys* fromType, TsysConv conv) = 0;
+	virtual TsysCacheStatistics	GetConvCacheStatistics() = 0;
+
+	// signature is built by the caller from candidates and arguments of a call
+	// it contains addresses of symbols, so an entry only hits in the generation of the translation unit that creates it
+	virtual bool				GetCachedOverload(const Array<vint>& signature, vint generation, List<ITsys*>& selected) = 0;
+	virtual void				SetCachedOverload(const Array<vint>& signature, vint generation, const List<ITsys*>& selected) = 0;
+	virtual TsysCacheStatistics	GetOverloadCacheStatistics() = 0;
+
+	// called once before any overlay is created, the allocator becomes read-only and the flag is only read after that
+	virtual void				Freeze() = 0;
+	virtual bool				IsOverlay() = 0;
+
 	static Ptr<ITsysAlloc>		Create();
+	// the base must be frozen, types only made of types in the base are reused if they exist before the base is frozen
+	static Ptr<ITsysAlloc>		CreateOverlay(Ptr<ITsysAlloc> base);
+};
+
+// New types made only of types in a frozen base are created in the overlay activated in the current thread
+// ParsingUnit activates its allocator if it is an overlay, a scope is only needed to make types without a ParsingUnit
+class TsysOverlayScope : public Object, private NotCopyable
+{
+protected:
+	ITsysAlloc*					previous;
+
+public:
+	TsysOverlayScope(Ptr<ITsysAlloc> overlay);
+	~TsysOverlayScope();
 };
 
 /***********************************************************************
@@ -225,5 +264,6 @@ struct ExprTsysItem
 
 extern TsysConv					TestFunctionQualifier(TsysCV thisCV, TsysRefType thisRef, Ptr<FunctionType> funcType);
 extern TsysConv					TestConvert(ParsingArguments& pa, ITsys* toType, ExprTsysItem fromItem);
+extern TsysConv					TestConvert(ParsingArguments& pa, ITsys* toType, ExprTsysItem fromItem, bool& cacheable);
 
 #endif
\ No newline at end of file
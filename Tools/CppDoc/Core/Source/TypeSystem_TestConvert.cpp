@@ -19,7 +19,7 @@ TsysConv TestFunctionQualifier(TsysCV thisCV, TsysRefType thisRef, Ptr<FunctionT
 	return TsysConv::TrivalConversion;
 }
 
-TsysConv TestConvertInternal(ParsingArguments& pa, ITsys* toType, ITsys* fromType);
+TsysConv TestConvertInternal(ParsingArguments& pa, ITsys* toType, ITsys* fromType, bool& cacheable);
 
 namespace TestConvert_Helpers
 {
@@ -72,6 +72,23 @@ namespace TestConvert_Helpers
 		return symbol->decls[0].Cast<T>();
 	}
 
+	bool IsIncompleteClassInvolved(ITsys* type)
+	{
+		// a class that is only forward declared or still being parsed could be completed later
+		TsysCV cv;
+		TsysRefType ref;
+		auto entity = type->GetEntity(cv, ref);
+		while (entity->GetType() == TsysType::Ptr || entity->GetType() == TsysType::Array)
+		{
+			entity = entity->GetElement()->GetEntity(cv, ref);
+		}
+
+		if (entity->GetType() != TsysType::Decl) return false;
+		auto symbol = entity->GetDecl();
+		if (symbol->decls.Count() == 0) return false;
+		return symbol->decls[0].Cast<ForwardClassDeclaration>() && !symbol->isCompleteClass;
+	}
+
 	bool IsExactOrTrivalConvert(ITsys* toType, ITsys* fromType, bool fromLRP, bool& performedTrivalConversion)
 	{
 		TsysCV toCV, fromCV;
@@ -188,6 +205,49 @@ namespace TestConvert_Helpers
 		return true;
 	}
 
+	constexpr vint PrimitiveCount = (vint)TsysPrimitiveType::_COUNT * (vint)TsysBytes::_COUNT;
+
+	constexpr vint GetPrimitiveIndex(TsysPrimitiveType type, TsysBytes bytes)
+	{
+		return (vint)type * (vint)TsysBytes::_COUNT + (vint)bytes;
+	}
+
+	// the same rule as IsNumericPromotion and IsNumericConversion, for both entities are primitive types
+	constexpr TsysConv GetPrimitiveConversion(vint to, vint from)
+	{
+		auto toType = (TsysPrimitiveType)(to / (vint)TsysBytes::_COUNT);
+		auto fromType = (TsysPrimitiveType)(from / (vint)TsysBytes::_COUNT);
+		auto toBytes = to % (vint)TsysBytes::_COUNT;
+		auto fromBytes = from % (vint)TsysBytes::_COUNT;
+
+		if (toType == TsysPrimitiveType::Void || fromType == TsysPrimitiveType::Void) return TsysConv::Illegal;
+		if ((toType == TsysPrimitiveType::Float) == (fromType == TsysPrimitiveType::Float) && toBytes > fromBytes) return TsysConv::IntegralPromotion;
+		return TsysConv::StandardConversion;
+	}
+
+	struct PrimitiveConversionTable
+	{
+		TsysConv				items[PrimitiveCount][PrimitiveCount];
+
+		constexpr PrimitiveConversionTable()
+			:items{}
+		{
+			for (vint i = 0; i < PrimitiveCount; i++)
+			{
+				for (vint j = 0; j < PrimitiveCount; j++)
+				{
+					items[i][j] = GetPrimitiveConversion(i, j);
+				}
+			}
+		}
+	};
+
+	constexpr PrimitiveConversionTable primitiveConversions;
+
+	static_assert(primitiveConversions.items[GetPrimitiveIndex(TsysPrimitiveType::SInt, TsysBytes::_4)][GetPrimitiveIndex(TsysPrimitiveType::SChar, TsysBytes::_1)] == TsysConv::IntegralPromotion, "char -> int should be IntegralPromotion");
+	static_assert(primitiveConversions.items[GetPrimitiveIndex(TsysPrimitiveType::SInt, TsysBytes::_4)][GetPrimitiveIndex(TsysPrimitiveType::Float, TsysBytes::_8)] == TsysConv::StandardConversion, "double -> int should be StandardConversion");
+	static_assert(primitiveConversions.items[GetPrimitiveIndex(TsysPrimitiveType::Void, TsysBytes::_1)][GetPrimitiveIndex(TsysPrimitiveType::SInt, TsysBytes::_4)] == TsysConv::Illegal, "int -> void should be Illegal");
+
 	bool IsNumericPromotion(ITsys* toType, ITsys* fromType)
 	{
 		if (toType->GetType() != TsysType::Primitive) return false;
@@ -246,7 +306,7 @@ namespace TestConvert_Helpers
 		return false;
 	}
 
-	bool IsToBaseClassConversion(ParsingArguments& pa, ITsys* toType, ITsys* fromType)
+	bool IsToBaseClassConversion(ParsingArguments& pa, ITsys* toType, ITsys* fromType, bool& cacheable)
 	{
 		{
 			TsysCV toCV, fromCV;
@@ -305,6 +365,7 @@ namespace TestConvert_Helpers
 			if (currentType == toType) return true;
 			if (auto currentClass = TryGetDeclFromType<ClassDeclaration>(currentType))
 			{
+				if (!currentClass->symbol->isCompleteClass) cacheable = false;
 				ParsingArguments newPa(pa, currentClass->symbol);
 				for (vint j = 0; j < currentClass->baseTypes.Count(); j++)
 				{
@@ -323,7 +384,7 @@ namespace TestConvert_Helpers
 		return false;
 	}
 
-	bool IsCustomOperatorConversion(ParsingArguments& pa, ITsys* toType, ITsys* fromType)
+	bool IsCustomOperatorConversion(ParsingArguments& pa, ITsys* toType, ITsys* fromType, bool& cacheable)
 	{
 		TsysCV fromCV;
 		TsysRefType fromRef;
@@ -333,6 +394,7 @@ namespace TestConvert_Helpers
 		if (!fromClass) return false;
 
 		auto fromSymbol = fromClass->symbol;
+		if (!fromSymbol->isCompleteClass) cacheable = false;
 		vint index = fromSymbol->children.Keys().IndexOf(L"$__type");
 		if (index == -1) return false;
 		const auto& typeOps = fromSymbol->children.GetByIndex(index);
@@ -353,7 +415,7 @@ namespace TestConvert_Helpers
 			TypeToTsys(newPa, typeOpType->returnType, targetTypes);
 			for (vint j = 0; j < targetTypes.Count(); j++)
 			{
-				if (TestConvertInternal(newPa, toType, targetTypes[j]->RRefOf()) != TsysConv::Illegal)
+				if (TestConvertInternal(newPa, toType, targetTypes[j]->RRefOf(), cacheable) != TsysConv::Illegal)
 				{
 					return true;
 				}
@@ -363,7 +425,7 @@ namespace TestConvert_Helpers
 		return false;
 	}
 
-	bool IsCustomContructorConversion(ParsingArguments& pa, ITsys* toType, ITsys* fromType)
+	bool IsCustomContructorConversion(ParsingArguments& pa, ITsys* toType, ITsys* fromType, bool& cacheable)
 	{
 		TsysCV toCV;
 		TsysRefType toRef;
@@ -374,7 +436,8 @@ namespace TestConvert_Helpers
 		if (!toClass) return false;
 
 		auto toSymbol = toClass->symbol;
-		if (TestConvertInternal(pa, toType, pa.tsys->DeclOf(toSymbol)->RRefOf()) == TsysConv::Illegal) return false;
+		if (!toSymbol->isCompleteClass) cacheable = false;
+		if (TestConvertInternal(pa, toType, pa.unit->tsys->DeclOf(toSymbol)->RRefOf(), cacheable) == TsysConv::Illegal) return false;
 
 		vint index = toSymbol->children.Keys().IndexOf(L"$__ctor");
 		if (index == -1) return false;
@@ -395,7 +458,7 @@ namespace TestConvert_Helpers
 			TypeToTsys(newPa, ctorType->parameters[0]->type, sourceTypes);
 			for (vint j = 0; j < sourceTypes.Count(); j++)
 			{
-				if (TestConvertInternal(newPa, sourceTypes[j], fromType) != TsysConv::Illegal)
+				if (TestConvertInternal(newPa, sourceTypes[j], fromType, cacheable) != TsysConv::Illegal)
 				{
 					return true;
 				}
@@ -407,12 +470,12 @@ namespace TestConvert_Helpers
 }
 using namespace TestConvert_Helpers;
 
-TsysConv TestConvertInternal(ParsingArguments& pa, ITsys* toType, ITsys* fromType)
+TsysConv TestConvertInternal(ParsingArguments& pa, ITsys* toType, ITsys* fromType, bool& cacheable)
 {
 	if (fromType->GetType() == TsysType::Zero)
 	{
 		if (toType->GetType() == TsysType::Ptr) return TsysConv::TrivalConversion;
-		fromType = pa.tsys->Int();
+		fromType = pa.unit->tsys->Int();
 	}
 
 	if (fromType->GetType() == TsysType::Nullptr)
@@ -428,6 +491,11 @@ TsysConv TestConvertInternal(ParsingArguments& pa, ITsys* toType, ITsys* fromTyp
 		}
 	}
 
+	if (IsIncompleteClassInvolved(toType) || IsIncompleteClassInvolved(fromType))
+	{
+		cacheable = false;
+	}
+
 	auto toEntity = toType;
 	auto fromEntity = fromType;
 	if (!IsEntityConversionAllowed(toEntity, fromEntity))
@@ -435,17 +503,47 @@ TsysConv TestConvertInternal(ParsingArguments& pa, ITsys* toType, ITsys* fromTyp
 		return TsysConv::Illegal;
 	}
 
+	if (toEntity->GetType() == TsysType::Primitive && fromEntity->GetType() == TsysType::Primitive)
+	{
+		auto toP = toEntity->GetPrimitive();
+		auto fromP = fromEntity->GetPrimitive();
+		return primitiveConversions.items[GetPrimitiveIndex(toP.type, toP.bytes)][GetPrimitiveIndex(fromP.type, fromP.bytes)];
+	}
+
 	if (IsNumericPromotion(toEntity, fromEntity)) return TsysConv::IntegralPromotion;
 	if (IsNumericConversion(toEntity, fromEntity)) return TsysConv::StandardConversion;
 	if (IsPointerConversion(toEntity, fromEntity)) return TsysConv::StandardConversion;
-	if (IsToBaseClassConversion(pa, toType, fromType)) return TsysConv::StandardConversion;
-	if (IsCustomOperatorConversion(pa, toType, fromType)) return TsysConv::UserDefinedConversion;
-	if (IsCustomContructorConversion(pa, toType, fromType)) return TsysConv::UserDefinedConversion;
+	if (IsToBaseClassConversion(pa, toType, fromType, cacheable)) return TsysConv::StandardConversion;
+	if (IsCustomOperatorConversion(pa, toType, fromType, cacheable)) return TsysConv::UserDefinedConversion;
+	if (IsCustomContructorConversion(pa, toType, fromType, cacheable)) return TsysConv::UserDefinedConversion;
 
 	return TsysConv::Illegal;
 }
 
 TsysConv TestConvert(ParsingArguments& pa, ITsys* toType, ExprTsysItem fromItem)
 {
-	return TestConvertInternal(pa, toType, (fromItem.type == ExprTsysType::LValue ? fromItem.tsys->LRefOf() : fromItem.tsys));
+	bool cacheable = true;
+	return TestConvert(pa, toType, fromItem, cacheable);
+}
+
+// cacheable is set to false if the result could change when more declarations are parsed
+TsysConv TestConvert(ParsingArguments& pa, ITsys* toType, ExprTsysItem fromItem, bool& cacheable)
+{
+	auto fromType = fromItem.type == ExprTsysType::LValue ? fromItem.tsys->LRefOf() : fromItem.tsys;
+
+	TsysConv result;
+	if (pa.unit->tsys->GetCachedConv(toType, fromType, result)) return result;
+
+	// a conversion that reads members of a class which is still being parsed could change later
+	bool cacheableConv = true;
+	result = TestConvertInternal(pa, toType, fromType, cacheableConv);
+	if (cacheableConv)
+	{
+		pa.unit->tsys->SetCachedConv(toType, fromType, result);
+	}
+	else
+	{
+		cacheable = false;
+	}
+	return result;
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include <Batch.h>
+
+using namespace vl::console;
+
+void PrintUsage()
+{
+	Console::WriteLine(L"Indexer.exe <output folder> [-j <workers>] (<preprocessed file> | @<manifest>)...");
+	Console::WriteLine(L"  -j          number of files being indexed at the same time, default to 4");
+	Console::WriteLine(L"  @manifest   a text file containing one preprocessed file in each line");
+}
+
+WString FormatSpeed(vint characters, vuint64_t milliseconds)
+{
+	return itow((vint)(characters / (milliseconds == 0 ? 1 : milliseconds))) + L" chars/ms";
+}
+
+int wmain(vint argc, wchar_t* args[])
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	vint workerCount = 4;
+	List<FilePath> inputs;
+	for (vint i = 2; i < argc; i++)
+	{
+		WString arg = args[i];
+		if (arg == L"-j" && i + 1 < argc)
+		{
+			workerCount = wtoi(args[++i]);
+		}
+		else if (arg.Length() > 1 && arg[0] == L'@')
+		{
+			if (!LoadIndexBatchManifest(arg.Right(arg.Length() - 1), inputs))
+			{
+				Console::WriteLine(L"Cannot read manifest: " + arg.Right(arg.Length() - 1));
+				return 1;
+			}
+		}
+		else
+		{
+			inputs.Add(arg);
+		}
+	}
+
+	IndexBatch batch(FilePath(args[1]), workerCount);
+	for (vint i = 0; i < inputs.Count(); i++)
+	{
+		batch.Add(inputs[i]);
+	}
+
+	vint characters = 0;
+	vint failed = 0;
+	auto start = DateTime::LocalTime().totalMilliseconds;
+	bool started = batch.Run([&](const IndexBatchFile& file)
+	{
+		if (file.succeeded)
+		{
+			characters += file.characters;
+			Console::WriteLine(
+				L"[OK]     " + file.input.GetFullPath()
+				+ L": " + itow(file.records) + L" records, "
+				+ u64tow(file.milliseconds) + L" ms, "
+				+ FormatSpeed(file.characters, file.milliseconds));
+		}
+		else
+		{
+			failed++;
+			Console::WriteLine(L"[FAILED] " + file.input.GetFullPath() + L": " + file.error);
+		}
+	});
+	auto milliseconds = DateTime::LocalTime().totalMilliseconds - start;
+
+	if (!started)
+	{
+		Console::WriteLine(L"Cannot create the output folder: " + FilePath(args[1]).GetFullPath());
+		FinalizeGlobalStorage();
+		return 1;
+	}
+
+	Console::WriteLine(
+		itow(batch.GetFileCount() - failed) + L" indexed, "
+		+ itow(failed) + L" failed, "
+		+ u64tow(milliseconds) + L" ms, "
+		+ FormatSpeed(characters, milliseconds));
+
+	FinalizeGlobalStorage();
+	return failed == 0 ? 0 : 1;
+}
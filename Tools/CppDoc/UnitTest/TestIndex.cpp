@@ -0,0 +1,255 @@
+#include <Batch.h>
+#include "Util.h"
+
+TEST_CASE(TestIndex_SaveAndLoad)
+{
+	auto input = LR"(
+namespace a
+{
+	struct X {};
+}
+a::X x;
+a::X* F(a::X);
+)";
+	auto recorder = MakePtr<IndexRecorder>();
+	COMPILE_PROGRAM_WITH_RECORDER(program, pa, input, recorder);
+	TEST_ASSERT(recorder->GetRecordCount() > 0);
+
+	MemoryStream stream;
+	recorder->Save(stream);
+	stream.SeekFromBegin(0);
+
+	List<IndexRecord> records;
+	List<WString> symbolNames;
+	TEST_ASSERT(LoadIndex(stream, records, symbolNames));
+	TEST_ASSERT(records.Count() == recorder->GetRecordCount());
+	TEST_ASSERT(symbolNames.Count() == recorder->GetSymbolCount());
+
+	for (vint i = 0; i < symbolNames.Count(); i++)
+	{
+		TEST_ASSERT(symbolNames[i] == GetSymbolFullName(recorder->GetSymbol(i)));
+	}
+	TEST_ASSERT(symbolNames.Contains(L"::a"));
+	TEST_ASSERT(symbolNames.Contains(L"::a::X"));
+
+	for (vint i = 0; i < records.Count(); i++)
+	{
+		if (i > 0)
+		{
+			TEST_ASSERT(records[i - 1].offset <= records[i].offset);
+		}
+
+		bool found = false;
+		for (vint j = 0; j < recorder->GetRecordCount(); j++)
+		{
+			auto record = recorder->GetRecord(j);
+			if (record.offset == records[i].offset && record.symbolId == records[i].symbolId && record.reason == records[i].reason)
+			{
+				found = true;
+				break;
+			}
+		}
+		TEST_ASSERT(found);
+	}
+
+	{
+		MemoryStream broken;
+		vuint8_t bytes[] = { 1, 2, 3, 4 };
+		broken.Write(bytes, sizeof(bytes));
+		broken.SeekFromBegin(0);
+		TEST_ASSERT(!LoadIndex(broken, records, symbolNames));
+	}
+}
+
+TEST_CASE(TestIndex_FileView)
+{
+	WString input = L"struct X {}; struct Y {};";
+	for (vint i = 0; i < 100; i++)
+	{
+		input += L"X x" + itow(i) + L"; Y* y" + itow(i) + L";";
+	}
+	auto recorder = MakePtr<IndexRecorder>();
+	COMPILE_PROGRAM_WITH_RECORDER(program, pa, input, recorder);
+	TEST_ASSERT(recorder->GetRecordCount() > IndexFileBlockSize);
+
+	MemoryStream stream;
+	recorder->Save(stream);
+	Array<vuint8_t> bytes((vint)stream.Size());
+	stream.SeekFromBegin(0);
+	stream.Read(&bytes[0], bytes.Count());
+
+	IndexFileView view(&bytes[0], bytes.Count());
+	TEST_ASSERT(view.IsValid());
+	TEST_ASSERT(view.GetRecordCount() == recorder->GetRecordCount());
+	TEST_ASSERT(view.GetSymbolCount() == recorder->GetSymbolCount());
+
+	for (vint i = 0; i < recorder->GetSymbolCount(); i++)
+	{
+		List<vint> expected, actual;
+		for (vint j = 0; j < recorder->GetRecordCount(); j++)
+		{
+			auto record = recorder->GetRecord(j);
+			if (record.symbolId == i)
+			{
+				expected.Add(record.offset);
+			}
+		}
+		view.FindReferences(i, actual);
+		TEST_ASSERT(CompareEnumerable(From(expected).OrderBy([](vint a, vint b) { return a - b; }), actual) == 0);
+	}
+
+	for (vint i = 0; i < recorder->GetRecordCount(); i++)
+	{
+		auto record = recorder->GetRecord(i);
+		List<vint> symbolIds;
+		view.FindSymbolsAt(record.offset, symbolIds);
+		TEST_ASSERT(symbolIds.Contains(record.symbolId));
+
+		symbolIds.Clear();
+		view.FindSymbolsAt(record.offset + 1, symbolIds);
+		TEST_ASSERT(symbolIds.Count() == 0);
+	}
+
+	{
+		IndexFileView broken(&bytes[0], bytes.Count() - 1);
+		TEST_ASSERT(!broken.IsValid());
+	}
+}
+
+TEST_CASE(TestIndex_CorruptedHeader)
+{
+	auto input = LR"(
+struct X {};
+X x;
+)";
+	auto recorder = MakePtr<IndexRecorder>();
+	COMPILE_PROGRAM_WITH_RECORDER(program, pa, input, recorder);
+
+	MemoryStream stream;
+	recorder->Save(stream);
+	Array<vuint8_t> bytes((vint)stream.Size());
+	stream.SeekFromBegin(0);
+	stream.Read(&bytes[0], bytes.Count());
+
+	auto writeFixed = [](Array<vuint8_t>& corrupted, vint index, vuint32_t value)
+	{
+		corrupted[index * 4] = (vuint8_t)value;
+		corrupted[index * 4 + 1] = (vuint8_t)(value >> 8);
+		corrupted[index * 4 + 2] = (vuint8_t)(value >> 16);
+		corrupted[index * 4 + 3] = (vuint8_t)(value >> 24);
+	};
+
+	auto isLoaded = [&](Array<vuint8_t>& corrupted)
+	{
+		IndexFileView view(&corrupted[0], corrupted.Count());
+		MemoryWrapperStream corruptedStream(&corrupted[0], corrupted.Count());
+		List<IndexRecord> records;
+		List<WString> symbolNames;
+		bool loaded = LoadIndex(corruptedStream, records, symbolNames);
+		TEST_ASSERT(view.IsValid() || !loaded);
+		return loaded;
+	};
+
+	{
+		Array<vuint8_t> corrupted;
+		CopyFrom(corrupted, bytes);
+		TEST_ASSERT(isLoaded(corrupted));
+	}
+
+	// counts and sizes in the header, including ones that overflow when multiplied
+	vuint32_t values[] = { 0xFFFFFFFF, 0x80000000, 0x7FFFFFFF, 0x40000000, 0x20000001 };
+	const vint ValueCount = sizeof(values) / sizeof(*values);
+	for (vint field = 2; field < 8; field++)
+	{
+		for (vint i = 0; i < ValueCount; i++)
+		{
+			Array<vuint8_t> corrupted;
+			CopyFrom(corrupted, bytes);
+			writeFixed(corrupted, field, values[i]);
+			TEST_ASSERT(!isLoaded(corrupted));
+		}
+	}
+
+	// a record referencing a symbol that doesn't exist
+	{
+		vint symbolCount = recorder->GetSymbolCount();
+		vint blockCount = (recorder->GetRecordCount() + IndexFileBlockSize - 1) / IndexFileBlockSize;
+		vint records = (8 + blockCount * 2 + (symbolCount + 1) * 2) * 4;
+
+		Array<vuint8_t> corrupted;
+		CopyFrom(corrupted, bytes);
+		TEST_ASSERT(corrupted[records + 1] < 0x80);
+		corrupted[records + 1] = (vuint8_t)(symbolCount << 1);
+		TEST_ASSERT(!isLoaded(corrupted));
+
+		// the view itself never returns the symbol id
+		IndexFileView view(&corrupted[0], corrupted.Count());
+		TEST_ASSERT(view.IsValid());
+
+		List<IndexRecord> decodedRecords;
+		view.GetRecords(decodedRecords);
+		TEST_ASSERT(decodedRecords.Count() == 0);
+
+		IndexFileView originalView(&bytes[0], bytes.Count());
+		List<IndexRecord> originalRecords;
+		originalView.GetRecords(originalRecords);
+		List<vint> symbolIds;
+		view.FindSymbolsAt(originalRecords[0].offset, symbolIds);
+		TEST_ASSERT(symbolIds.Count() == 0);
+	}
+}
+
+TEST_CASE(TestIndex_Batch)
+{
+	FilePath folder = L"../../../.Output/IndexBatch";
+	TEST_ASSERT(Folder(folder / L"Input").Exists() || Folder(folder / L"Input").Create(true));
+
+	List<WString> lines;
+	lines.Add(L"# inputs");
+	for (vint i = 0; i < 5; i++)
+	{
+		auto name = L"File" + itow(i) + L".cpp";
+		auto code = i == 4
+			? WString(L"a::X x;")
+			: L"namespace a { struct X" + itow(i) + L" {}; } a::X" + itow(i) + L" x;";
+		TEST_ASSERT(File(folder / L"Input" / name).WriteAllText(code));
+		lines.Add(L"Input/" + name);
+	}
+	TEST_ASSERT(File(folder / L"Manifest.txt").WriteAllLines(lines));
+
+	List<FilePath> inputs;
+	TEST_ASSERT(LoadIndexBatchManifest(folder / L"Manifest.txt", inputs));
+	TEST_ASSERT(inputs.Count() == 5);
+
+	IndexBatch batch(folder / L"Index", 2);
+	for (vint i = 0; i < inputs.Count(); i++)
+	{
+		batch.Add(inputs[i]);
+	}
+
+	vint reported = 0;
+	TEST_ASSERT(batch.Run([&](const IndexBatchFile&) { reported++; }));
+	TEST_ASSERT(reported == 5);
+
+	for (vint i = 0; i < batch.GetFileCount(); i++)
+	{
+		auto& file = batch.GetFile(i);
+		TEST_ASSERT(file.succeeded == (i != 4));
+		TEST_ASSERT(file.error == (i != 4 ? L"" : L"Cannot parse at row 1, column 2."));
+		if (!file.succeeded) continue;
+
+		FileStream stream(file.output.GetFullPath(), FileStream::ReadOnly);
+		List<IndexRecord> records;
+		List<WString> symbolNames;
+		TEST_ASSERT(LoadIndex(stream, records, symbolNames));
+		TEST_ASSERT(records.Count() == file.records);
+		TEST_ASSERT(symbolNames.Contains(L"::a::X" + itow(i)));
+	}
+
+	// the output folder cannot be created under a file
+	IndexBatch brokenBatch(folder / L"Manifest.txt" / L"Index", 2);
+	brokenBatch.Add(inputs[0]);
+	reported = 0;
+	TEST_ASSERT(!brokenBatch.Run([&](const IndexBatchFile&) { reported++; }));
+	TEST_ASSERT(reported == 0);
+}
@@ -7,7 +7,8 @@ Predefined Types
 
 ITsys* GetTsysFromCppType(Ptr<ITsysAlloc> tsys, const WString& cppType)
 {
-	ParsingArguments pa(nullptr, tsys, nullptr);
+	ParsingUnit unit(nullptr, tsys, nullptr);
+	ParsingArguments pa(&unit);
 	CppTokenReader reader(GlobalCppLexer(), cppType);
 	auto cursor = reader.GetFirstToken();
 	auto type = ParseType(pa, cursor);
@@ -256,7 +257,7 @@ void AssertPostfixUnary(ParsingArguments& pa, const WString& name, const WString
 {
 	auto input = name + op;
 	auto log = L"(" + name + L" " + op + L")";
-	auto tsys = TsysInfo<T>::GetTsys(pa.tsys);
+	auto tsys = TsysInfo<T>::GetTsys(pa.unit->tsys);
 	AssertExpr(input, log, TsysToString(tsys), pa);
 }
 
@@ -279,7 +280,7 @@ void AssertPrefixUnary(ParsingArguments& pa, const WString& name, const WString&
 {
 	auto input = op + name;
 	auto log = L"(" + op + L" " + name + L")";
-	auto tsys = TsysInfo<T>::GetTsys(pa.tsys);
+	auto tsys = TsysInfo<T>::GetTsys(pa.unit->tsys);
 	AssertExpr(input, log, TsysToString(tsys), pa);
 }
 
@@ -288,7 +289,7 @@ void AssertDereferenceUnary(ParsingArguments& pa, const WString& name)
 {
 	auto input = L"*&" + name;
 	auto log = L"(* (& " + name + L"))";
-	auto tsys = TsysInfo<T>::GetTsys(pa.tsys);
+	auto tsys = TsysInfo<T>::GetTsys(pa.unit->tsys);
 	AssertExpr(input, log, TsysToString(tsys), pa);
 }
 
@@ -341,7 +342,7 @@ void AssertBinary(ParsingArguments& pa, const WString& name1, const WString& nam
 {
 	auto input = name1 + op + name2;
 	auto log = L"(" + name1 + L" " + op + L" " + name2 + L")";
-	auto tsys = TsysInfo<T>::GetTsys(pa.tsys);
+	auto tsys = TsysInfo<T>::GetTsys(pa.unit->tsys);
 	AssertExpr(input, log, TsysToString(tsys), pa);
 }
 
@@ -1,3 +1,4 @@
+#include <Ast_Decl.h>
 #include "Util.h"
 
 #pragma warning (push)
@@ -139,6 +140,13 @@ wchar_t F(int, double = 0);
 		ASSERT_OVERLOADING(F(0,0),							L"F(0, 0)",								char);
 		ASSERT_OVERLOADING(F(0,0.0),						L"F(0, 0.0)",							wchar_t);
 		ASSERT_OVERLOADING(F(0,0.0f),						L"F(0, 0.0f)",							wchar_t);
+
+		const auto& fs = pa.unit->root->children[L"F"];
+		TEST_ASSERT(fs[2]->functionArity.cached);
+		TEST_ASSERT(fs[2]->functionArity.isFunction);
+		TEST_ASSERT(fs[2]->functionArity.minParameterCount == 1);
+		TEST_ASSERT(fs[2]->functionArity.maxParameterCount == 2);
+		TEST_ASSERT(!fs[2]->functionArity.ellipsis);
 	}
 }
 
@@ -1020,6 +1028,75 @@ TEST_CASE(TestParseExpr_Overloading_Binary)
 	ASSERT_OVERLOADING(0^=cz,								L"(0 ^= cz)",							bool *);
 }
 
+TEST_CASE(TestParseExpr_Overloading_OperatorCandidateCache)
+{
+	auto input = LR"(
+struct S
+{
+	S& operator<<(int);
+};
+S& operator<<(S&, double);
+S s;
+void G() { s << 1; }
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	AssertExpr(L"(s << 1) << 2.0",						L"(((s << 1)) << 2.0)",					L"::S & $L",		pa);
+
+	auto symbolS = pa.unit->root->children[L"S"][0].Obj();
+	TEST_ASSERT(symbolS->operatorCandidateCache);
+	TEST_ASSERT(symbolS->operatorCandidateCache->candidates.Count() == 1);
+	auto candidates = symbolS->operatorCandidateCache->candidates[L"operator <<"];
+	TEST_ASSERT(candidates->methods.values && candidates->methods.values->resolvedSymbols.Count() == 1);
+	TEST_ASSERT(candidates->funcs.values && candidates->funcs.values->resolvedSymbols.Count() == 1);
+
+	// local variables do not invalidate candidates
+	auto block = program->decls[3].Cast<FunctionDeclaration>()->statement;
+	auto local = MakePtr<VariableDeclaration>();
+	local->name.name = L"y";
+	block->symbol->CreateDeclSymbol(local);
+	AssertExpr(L"s << 1",								L"(s << 1)",							L"::S & $L",		pa);
+	TEST_ASSERT(symbolS->operatorCandidateCache->candidates[L"operator <<"] == candidates);
+
+	// a new operator does
+	CppTokenReader operatorReader(GlobalCppLexer(), L"S& operator<<(S&, char);");
+	auto operatorCursor = operatorReader.GetFirstToken();
+	ParseProgram(pa, operatorCursor);
+	AssertExpr(L"s << 'a'",								L"(s << 'a')",							L"::S & $L",		pa);
+	candidates = symbolS->operatorCandidateCache->candidates[L"operator <<"];
+	TEST_ASSERT(candidates->funcs.values && candidates->funcs.values->resolvedSymbols.Count() == 2);
+}
+
+TEST_CASE(TestParseExpr_Overloading_Cache)
+{
+	TEST_DECL(
+bool F(void*);
+char F(int, int);
+wchar_t F(int, double = 0);
+	);
+	COMPILE_PROGRAM(program, pa, input);
+
+	auto stat1 = pa.unit->tsys->GetOverloadCacheStatistics();
+	ASSERT_OVERLOADING(F(0),								L"F(0)",								wchar_t);
+	auto stat2 = pa.unit->tsys->GetOverloadCacheStatistics();
+	ASSERT_OVERLOADING(F(0),								L"F(0)",								wchar_t);
+	auto stat3 = pa.unit->tsys->GetOverloadCacheStatistics();
+	ASSERT_OVERLOADING(F(0,0),								L"F(0, 0)",								char);
+	auto stat4 = pa.unit->tsys->GetOverloadCacheStatistics();
+
+	TEST_ASSERT(stat2.misses == stat1.misses + 1 && stat2.hits == stat1.hits);
+	TEST_ASSERT(stat3.misses == stat2.misses && stat3.hits == stat2.hits + 1);
+	TEST_ASSERT(stat4.misses == stat3.misses + 1 && stat4.hits == stat3.hits);
+
+	// entries are dropped when the symbol table changes
+	CppTokenReader declReader(GlobalCppLexer(), L"void G();");
+	auto declCursor = declReader.GetFirstToken();
+	ParseProgram(pa, declCursor);
+	ASSERT_OVERLOADING(F(0),								L"F(0)",								wchar_t);
+	auto stat5 = pa.unit->tsys->GetOverloadCacheStatistics();
+	TEST_ASSERT(stat5.misses == stat4.misses + 1 && stat5.hits == stat4.hits);
+}
+
 #undef ASSERT_OVERLOADING
 
 #pragma warning (pop)
\ No newline at end of file
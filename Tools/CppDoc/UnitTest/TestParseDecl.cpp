@@ -82,10 +82,10 @@ namespace a::b
 }
 )";
 	COMPILE_PROGRAM(program, pa, input);
-	TEST_ASSERT(pa.root->children[L"a"].Count() == 1);
-	TEST_ASSERT(pa.root->children[L"a"][0]->children[L"b"].Count() == 1);
-	TEST_ASSERT(pa.root->children[L"a"][0]->children[L"b"][0]->children[L"A"].Count() == 5);
-	const auto& symbols = pa.root->children[L"a"][0]->children[L"b"][0]->children[L"A"];
+	TEST_ASSERT(pa.unit->root->children[L"a"].Count() == 1);
+	TEST_ASSERT(pa.unit->root->children[L"a"][0]->children[L"b"].Count() == 1);
+	TEST_ASSERT(pa.unit->root->children[L"a"][0]->children[L"b"][0]->children[L"A"].Count() == 5);
+	const auto& symbols = pa.unit->root->children[L"a"][0]->children[L"b"][0]->children[L"A"];
 
 	for (vint i = 0; i < 5; i++)
 	{
@@ -146,10 +146,10 @@ namespace a::b
 }
 )";
 	COMPILE_PROGRAM(program, pa, input);
-	TEST_ASSERT(pa.root->children[L"a"].Count() == 1);
-	TEST_ASSERT(pa.root->children[L"a"][0]->children[L"b"].Count() == 1);
-	TEST_ASSERT(pa.root->children[L"a"][0]->children[L"b"][0]->children[L"x"].Count() == 5);
-	const auto& symbols = pa.root->children[L"a"][0]->children[L"b"][0]->children[L"x"];
+	TEST_ASSERT(pa.unit->root->children[L"a"].Count() == 1);
+	TEST_ASSERT(pa.unit->root->children[L"a"][0]->children[L"b"].Count() == 1);
+	TEST_ASSERT(pa.unit->root->children[L"a"][0]->children[L"b"][0]->children[L"x"].Count() == 5);
+	const auto& symbols = pa.unit->root->children[L"a"][0]->children[L"b"][0]->children[L"x"];
 
 	for (vint i = 0; i < 5; i++)
 	{
@@ -215,10 +215,10 @@ namespace a::b
 }
 )";
 	COMPILE_PROGRAM(program, pa, input);
-	TEST_ASSERT(pa.root->children[L"a"].Count() == 1);
-	TEST_ASSERT(pa.root->children[L"a"][0]->children[L"b"].Count() == 1);
-	TEST_ASSERT(pa.root->children[L"a"][0]->children[L"b"][0]->children[L"Add"].Count() == 5);
-	const auto& symbols = pa.root->children[L"a"][0]->children[L"b"][0]->children[L"Add"];
+	TEST_ASSERT(pa.unit->root->children[L"a"].Count() == 1);
+	TEST_ASSERT(pa.unit->root->children[L"a"][0]->children[L"b"].Count() == 1);
+	TEST_ASSERT(pa.unit->root->children[L"a"][0]->children[L"b"][0]->children[L"Add"].Count() == 5);
+	const auto& symbols = pa.unit->root->children[L"a"][0]->children[L"b"][0]->children[L"Add"];
 
 	for (vint i = 0; i < 5; i++)
 	{
@@ -347,10 +347,10 @@ namespace a::b
 	for (vint i = 0; i < 3; i++)
 	{
 		COMPILE_PROGRAM(program, pa, inputs[i]);
-		TEST_ASSERT(pa.root->children[L"a"].Count() == 1);
-		TEST_ASSERT(pa.root->children[L"a"][0]->children[L"b"].Count() == 1);
-		TEST_ASSERT(pa.root->children[L"a"][0]->children[L"b"][0]->children[L"X"].Count() == 5);
-		const auto& symbols = pa.root->children[L"a"][0]->children[L"b"][0]->children[L"X"];
+		TEST_ASSERT(pa.unit->root->children[L"a"].Count() == 1);
+		TEST_ASSERT(pa.unit->root->children[L"a"][0]->children[L"b"].Count() == 1);
+		TEST_ASSERT(pa.unit->root->children[L"a"][0]->children[L"b"][0]->children[L"X"].Count() == 5);
+		const auto& symbols = pa.unit->root->children[L"a"][0]->children[L"b"][0]->children[L"X"];
 
 		for (vint i = 0; i < 5; i++)
 		{
@@ -526,10 +526,10 @@ namespace a
 	COMPILE_PROGRAM(program, pa, input);
 	AssertProgram(program, output);
 
-	auto& inClassMembers = pa.root->children[L"a"][0]->children[L"b"][0]->children[L"Something"][0]->decls[0].Cast<ClassDeclaration>()->decls;
+	auto& inClassMembers = pa.unit->root->children[L"a"][0]->children[L"b"][0]->children[L"Something"][0]->decls[0].Cast<ClassDeclaration>()->decls;
 	TEST_ASSERT(inClassMembers.Count() == 13);
 
-	auto& outClassMembers = pa.root->children[L"a"][0]->children[L"b"][0]->decls[1].Cast<NamespaceDeclaration>()->decls;
+	auto& outClassMembers = pa.unit->root->children[L"a"][0]->children[L"b"][0]->decls[1].Cast<NamespaceDeclaration>()->decls;
 	TEST_ASSERT(outClassMembers.Count() == 12);
 
 	for (vint i = 0; i < 12; i++)
@@ -711,4 +711,238 @@ namespace c
 	});
 	AssertProgram(input, output, recorder);
 	TEST_ASSERT(accessed.Count() == 10);
-}
\ No newline at end of file
+}
+
+TEST_CASE(TestParseDecl_ClassMemberCache)
+{
+	auto input = LR"(
+struct A
+{
+	enum class X;
+	int y;
+};
+struct B : A
+{
+};
+struct C : B
+{
+	X x;
+};
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	auto symbolA = pa.unit->root->children[L"A"][0].Obj();
+	auto symbolC = pa.unit->root->children[L"C"][0].Obj();
+	TEST_ASSERT(symbolC->classMemberCache);
+	TEST_ASSERT(symbolC->classMemberCache->inheritedMembersFromSubClass.Keys().Contains(L"X"));
+
+	for (vint i = 0; i < 2; i++)
+	{
+		CppName name;
+		name.name = L"y";
+		auto result = ResolveSymbol({ pa,symbolC }, name, SearchPolicy::ChildSymbol);
+		TEST_ASSERT(!result.types);
+		TEST_ASSERT(result.values);
+		TEST_ASSERT(result.values->resolvedSymbols.Count() == 1);
+		TEST_ASSERT(result.values->resolvedSymbols[0] == symbolA->children[L"y"][0].Obj());
+	}
+	TEST_ASSERT(symbolC->classMemberCache->inheritedMembers.Count() == 1);
+}
+
+TEST_CASE(TestParseDecl_UsingNamespaceClosure)
+{
+	auto input = LR"(
+namespace a { struct X {}; }
+namespace b { using namespace a; }
+namespace c { using namespace b; }
+namespace d { struct Y {}; }
+namespace b { using namespace d; }
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	auto symbolC = pa.unit->root->children[L"c"][0].Obj();
+	TEST_ASSERT(symbolC->usingNss.Count() == 1);
+	TEST_ASSERT(symbolC->usingNssClosure.Count() == 3);
+
+	{
+		CppName name;
+		name.name = L"X";
+		auto result = ResolveSymbol({ pa,symbolC }, name, SearchPolicy::ChildSymbol);
+		TEST_ASSERT(result.types && result.types->resolvedSymbols.Count() == 1);
+		TEST_ASSERT(result.types->resolvedSymbols[0] == pa.unit->root->children[L"a"][0]->children[L"X"][0].Obj());
+	}
+	{
+		CppName name;
+		name.name = L"Y";
+		auto result = ResolveSymbol({ pa,symbolC }, name, SearchPolicy::ChildSymbol);
+		TEST_ASSERT(result.types && result.types->resolvedSymbols.Count() == 1);
+		TEST_ASSERT(result.types->resolvedSymbols[0] == pa.unit->root->children[L"d"][0]->children[L"Y"][0].Obj());
+	}
+}
+
+TEST_CASE(TestParseDecl_UsingNamespaceClosureHiding)
+{
+	auto input = LR"(
+namespace b { struct X {}; }
+namespace a { struct X {}; using namespace b; }
+namespace c { using namespace a; }
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	auto symbolC = pa.unit->root->children[L"c"][0].Obj();
+	TEST_ASSERT(symbolC->usingNssClosure.Count() == 2);
+	TEST_ASSERT(symbolC->usingNssClosureDepths[0] == 1);
+	TEST_ASSERT(symbolC->usingNssClosureDepths[1] == 2);
+
+	// a::X hides b::X
+	CppName name;
+	name.name = L"X";
+	auto result = ResolveSymbol({ pa,symbolC }, name, SearchPolicy::ChildSymbol);
+	TEST_ASSERT(result.types && result.types->resolvedSymbols.Count() == 1);
+	TEST_ASSERT(result.types->resolvedSymbols[0] == pa.unit->root->children[L"a"][0]->children[L"X"][0].Obj());
+}
+
+TEST_CASE(TestParseDecl_ChildrenFilter)
+{
+	auto input = LR"(
+namespace a { struct X {}; }
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	auto symbolA = pa.unit->root->children[L"a"][0].Obj();
+	TEST_ASSERT(symbolA->MayContainChild(Symbol::GetNameFilter(L"X")));
+	TEST_ASSERT(!symbolA->MayContainChild(Symbol::GetNameFilter(L"Y")));
+
+	CppName name;
+	name.name = L"Y";
+	TEST_ASSERT(!ResolveSymbol({ pa,symbolA }, name, SearchPolicy::ChildSymbol).types);
+
+	// a name rejected by the filter is found after it is added
+	CppTokenReader addedReader(GlobalCppLexer(), L"namespace a { struct Y {}; }");
+	auto addedCursor = addedReader.GetFirstToken();
+	ParseProgram(pa, addedCursor);
+	TEST_ASSERT(symbolA->MayContainChild(Symbol::GetNameFilter(L"Y")));
+
+	auto result = ResolveSymbol({ pa,symbolA }, name, SearchPolicy::ChildSymbol);
+	TEST_ASSERT(result.types && result.types->resolvedSymbols.Count() == 1);
+	TEST_ASSERT(result.types->resolvedSymbols[0] == symbolA->children[L"Y"][0].Obj());
+}
+
+TEST_CASE(TestParseDecl_ResolvedTypeHash)
+{
+	auto input = LR"(
+struct X;
+void F(X*, int);
+void F(X*, double);
+void F(X*, int);
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	const auto& fs = pa.unit->root->children[L"F"];
+	TEST_ASSERT(fs.Count() == 3);
+
+	auto t0 = fs[0]->decls[0].Cast<ForwardFunctionDeclaration>()->type;
+	auto t1 = fs[1]->decls[0].Cast<ForwardFunctionDeclaration>()->type;
+	auto t2 = fs[2]->decls[0].Cast<ForwardFunctionDeclaration>()->type;
+	TEST_ASSERT(t0->resolvedHashCached);
+	TEST_ASSERT(t1->resolvedHashCached);
+	TEST_ASSERT(t2->resolvedHashCached);
+	TEST_ASSERT(HashResolvedType(t0) == HashResolvedType(t2));
+	TEST_ASSERT(IsSameResolvedType(t0, t2));
+	TEST_ASSERT(!IsSameResolvedType(t0, t1));
+}
+
+TEST_CASE(TestParseDecl_ResolvedTypeUnsupported)
+{
+	ParsingUnit unit(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingArguments pa(&unit);
+	auto parseType = [&](const WString& input)
+	{
+		CppTokenReader reader(GlobalCppLexer(), input);
+		auto cursor = reader.GetFirstToken();
+		auto type = ParseType(pa, cursor);
+		TEST_ASSERT(!cursor);
+		return type;
+	};
+
+	auto tdecl = parseType(L"decltype(0)*");
+	auto tint = parseType(L"int*");
+	TEST_ASSERT(IsSameResolvedType(tint, tint));
+	TEST_ASSERT(!IsSameResolvedType(tint, tdecl));
+
+	// DeclType is not supported, the same object or a different hash does not skip comparing it
+	Ptr<Type> peers[] = { tdecl,tint };
+	for (vint i = 0; i < 2; i++)
+	{
+		try
+		{
+			IsSameResolvedType(tdecl, peers[i]);
+			TEST_ASSERT(false);
+		}
+		catch (int)
+		{
+		}
+	}
+}
+
+TEST_CASE(TestParseDecl_ForwardSignatureBuckets)
+{
+	{
+		auto input = LR"(
+void F(int);
+void F(double);
+void F(int);
+void F(int) {}
+)";
+		COMPILE_PROGRAM(program, pa, input);
+
+		const auto& fs = pa.unit->root->children[L"F"];
+		TEST_ASSERT(fs.Count() == 4);
+		TEST_ASSERT(pa.unit->root->forwardSignatures.Count() == 2);
+		TEST_ASSERT(fs[0]->forwardDeclarationRoot == fs[3].Obj());
+		TEST_ASSERT(fs[1]->forwardDeclarationRoot == nullptr);
+		TEST_ASSERT(fs[2]->forwardDeclarationRoot == fs[3].Obj());
+	}
+	{
+		// a sibling in another category is not in the same bucket, but it is still rejected
+		auto input = LR"(
+void F(int);
+)";
+		COMPILE_PROGRAM(program, pa, input);
+
+		auto item = MakePtr<EnumItemDeclaration>();
+		item->name.name = L"F";
+		pa.unit->root->CreateDeclSymbol(item);
+
+		CppTokenReader reader2(GlobalCppLexer(), input);
+		auto cursor2 = reader2.GetFirstToken();
+		try
+		{
+			ParseProgram(pa, cursor2);
+			TEST_ASSERT(false);
+		}
+		catch (const StopParsingException&)
+		{
+		}
+	}
+	{
+		// declarations of another kind use other buckets, but they are still rejected
+		auto input = LR"(
+void F(int);
+void F(double);
+int F;
+)";
+		CppTokenReader reader(GlobalCppLexer(), input);
+		auto cursor = reader.GetFirstToken();
+		ParsingUnit unit(new Symbol, ITsysAlloc::Create(), nullptr);
+		ParsingArguments pa(&unit);
+		try
+		{
+			ParseProgram(pa, cursor);
+			TEST_ASSERT(false);
+		}
+		catch (const StopParsingException&)
+		{
+		}
+	}
+}
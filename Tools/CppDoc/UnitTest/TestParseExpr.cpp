@@ -1,4 +1,5 @@
 #include <Ast_Decl.h>
+#include <Ast_Stat.h>
 #include "Util.h"
 
 TEST_CASE(TestParseExpr_Literal)
@@ -104,71 +105,71 @@ int z2(Z);
 	COMPILE_PROGRAM(program, pa, input);
 	{
 		SortedList<vint> accessed;
-		pa.recorder = CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
+		pa.unit->SetRecorder(CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
 		{
 			BEGIN_ASSERT_SYMBOL
 				ASSERT_SYMBOL(0, L"z1", 0, 0, VariableDeclaration, 30, 2)
 			END_ASSERT_SYMBOL
-		});
+		}));
 		AssertExpr(L"z1",			L"z1",					L"::c::Z $L",											pa);
 		TEST_ASSERT(accessed.Count() == 1);
 	}
 	{
 		SortedList<vint> accessed;
-		pa.recorder = CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
+		pa.unit->SetRecorder(CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
 		{
 			BEGIN_ASSERT_SYMBOL
 				ASSERT_SYMBOL(0, L"z2", 0, 2, ForwardFunctionDeclaration, 31, 4)
 			END_ASSERT_SYMBOL
-		});
+		}));
 		AssertExpr(L"::z2",			L"__root :: z2",		L"__int32 __cdecl(::c::Z) * $PR",						pa);
 		TEST_ASSERT(accessed.Count() == 1);
 	}
 	{
 		SortedList<vint> accessed;
-		pa.recorder = CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
+		pa.unit->SetRecorder(CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
 		{
 			BEGIN_ASSERT_SYMBOL
 				ASSERT_SYMBOL(0, L"Z", 0, 0, ClassDeclaration, 23, 8)
 				ASSERT_SYMBOL(1, L"u1", 0, 3, ForwardVariableDeclaration, 9, 11)
 			END_ASSERT_SYMBOL
-		});
+		}));
 		AssertExpr(L"Z::u1",		L"Z :: u1",				L"::a::X::Y $L",										pa);
 		TEST_ASSERT(accessed.Count() == 2);
 	}
 	{
 		SortedList<vint> accessed;
-		pa.recorder = CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
+		pa.unit->SetRecorder(CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
 		{
 			BEGIN_ASSERT_SYMBOL
 				ASSERT_SYMBOL(0, L"Z", 0, 2, ClassDeclaration, 23, 8)
 				ASSERT_SYMBOL(1, L"u2", 0, 5, VariableDeclaration, 10, 4)
 			END_ASSERT_SYMBOL
-		});
+		}));
 		AssertExpr(L"::Z::u2",		L"__root :: Z :: u2",	L"::a::X::Y (::a::X ::) * $PR",					pa);
 		TEST_ASSERT(accessed.Count() == 2);
 	}
 	{
 		SortedList<vint> accessed;
-		pa.recorder = CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
+		pa.unit->SetRecorder(CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
 		{
 			BEGIN_ASSERT_SYMBOL
 				ASSERT_SYMBOL(0, L"Z", 0, 0, ClassDeclaration, 23, 8)
 				ASSERT_SYMBOL(1, L"v1", 0, 3, FunctionDeclaration, 11, 13)
 			END_ASSERT_SYMBOL
-		});
+		}));
 		AssertExpr(L"Z::v1",		L"Z :: v1",				L"__int32 __cdecl(::a::X::Y &) * $PR",					pa);
 		TEST_ASSERT(accessed.Count() == 2);
 	}
 	{
 		SortedList<vint> accessed;
-		pa.recorder = CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
+		pa.unit->SetRecorder(CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
 		{
 			BEGIN_ASSERT_SYMBOL
 				ASSERT_SYMBOL(0, L"Z", 0, 2, ClassDeclaration, 23, 8)
 				ASSERT_SYMBOL(1, L"v2", 0, 5, FunctionDeclaration, 12, 6)
 			END_ASSERT_SYMBOL
-		});
+		}));
 		AssertExpr(L"::Z::v2",		L"__root :: Z :: v2",	L"__int32 __thiscall(::a::X::Y &) (::a::X ::) * $PR",	pa);
 		TEST_ASSERT(accessed.Count() == 2);
 	}
@@ -765,4 +766,162 @@ TEST_CASE(TestParseExpr_Lambda)
 	// TsysType::CapturedLambda
 	// GetElement() returns a function type
 	// GetDecl() returns the scope inside the lambda
-}
\ No newline at end of file
+}
+
+TEST_CASE(TestParseExpr_TsysCache)
+{
+	auto input = LR"(
+int x;
+double F(int);
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	CppTokenReader exprReader(GlobalCppLexer(), L"F(x) + F(x)");
+	auto exprCursor = exprReader.GetFirstToken();
+	auto expr = ParseExpr(pa, true, exprCursor);
+	TEST_ASSERT(!exprCursor);
+
+	auto& statistics = pa.unit->exprTsysCacheStatistics;
+	auto hits = statistics.hits;
+	ExprTsysList types1, types2, types3;
+	ExprToTsys(pa, expr, types1);
+	ExprToTsys(pa, expr, types2);
+	TEST_ASSERT(statistics.hits == hits + 1);
+	TEST_ASSERT(CompareEnumerable(types1, types2) == 0);
+
+	hits = statistics.hits;
+	auto misses = statistics.misses;
+	pa.unit->exprTsysCacheEnabled = false;
+	ExprToTsys(pa, expr, types3);
+	pa.unit->exprTsysCacheEnabled = true;
+	TEST_ASSERT(statistics.hits == hits);
+	TEST_ASSERT(statistics.misses == misses);
+	TEST_ASSERT(CompareEnumerable(types1, types3) == 0);
+}
+
+TEST_CASE(TestParseExpr_TsysCacheAcrossStatements)
+{
+	auto input = LR"(
+int x;
+double F(int);
+void G()
+{
+	F(x);
+}
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	auto block = program->decls[2].Cast<FunctionDeclaration>()->statement;
+	ParsingArguments blockPa(pa, block->symbol);
+	CppTokenReader exprReader(GlobalCppLexer(), L"F(x)");
+	auto exprCursor = exprReader.GetFirstToken();
+	auto expr = ParseExpr(blockPa, true, exprCursor);
+	TEST_ASSERT(!exprCursor);
+
+	auto& statistics = pa.unit->exprTsysCacheStatistics;
+	ExprTsysList types1, types2, types3;
+	ExprToTsys(blockPa, expr, types1);
+
+	// local variables and statements only affect code after them
+	auto hits = statistics.hits;
+	auto local = MakePtr<VariableDeclaration>();
+	local->name.name = L"y";
+	block->symbol->CreateDeclSymbol(local);
+	block->symbol->CreateStatSymbol(MakePtr<BlockStat>());
+	ExprToTsys(blockPa, expr, types2);
+	TEST_ASSERT(statistics.hits == hits + 1);
+	TEST_ASSERT(CompareEnumerable(types1, types2) == 0);
+
+	// other changes invalidate cached results
+	hits = statistics.hits;
+	auto global = MakePtr<VariableDeclaration>();
+	global->name.name = L"z";
+	pa.unit->root->CreateDeclSymbol(global);
+	ExprToTsys(blockPa, expr, types3);
+	TEST_ASSERT(statistics.hits == hits);
+	TEST_ASSERT(CompareEnumerable(types1, types3) == 0);
+}
+
+TEST_CASE(TestParseExpr_TsysCacheLocalShadowing)
+{
+	auto input = LR"(
+int x;
+double F(int);
+void G()
+{
+	F(x);
+}
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	auto block = program->decls[2].Cast<FunctionDeclaration>()->statement;
+	ParsingArguments blockPa(pa, block->symbol);
+	CppTokenReader exprReader(GlobalCppLexer(), L"F(x)");
+	auto exprCursor = exprReader.GetFirstToken();
+	auto expr = ParseExpr(blockPa, true, exprCursor);
+	TEST_ASSERT(!exprCursor);
+	CppTokenReader typeReader(GlobalCppLexer(), L"decltype(x)");
+	auto typeCursor = typeReader.GetFirstToken();
+	auto type = ParseType(blockPa, typeCursor);
+	TEST_ASSERT(!typeCursor);
+
+	ExprTsysList exprTypes;
+	TypeTsysList typeTypes;
+	ExprToTsys(blockPa, expr, exprTypes);
+	TypeToTsys(blockPa, type, typeTypes);
+	TEST_ASSERT(expr->tsysCache->entries.Count() == 1);
+	TEST_ASSERT(type->tsysCache->entries.Count() == 1);
+	TEST_ASSERT(expr->tsysCache->entries[0]->generation == pa.unit->GetGeneration());
+	TEST_ASSERT(type->tsysCache->entries[0]->generation == pa.unit->GetGeneration());
+
+	// a local variable hiding an outer name drops cached results
+	auto local = MakePtr<VariableDeclaration>();
+	local->name.name = L"x";
+	block->symbol->CreateDeclSymbol(local);
+	TEST_ASSERT(expr->tsysCache->entries[0]->generation != pa.unit->GetGeneration());
+	TEST_ASSERT(type->tsysCache->entries[0]->generation != pa.unit->GetGeneration());
+
+	auto& statistics = pa.unit->exprTsysCacheStatistics;
+	auto hits = statistics.hits;
+	ExprTsysList exprTypes2;
+	ExprToTsys(blockPa, expr, exprTypes2);
+	TEST_ASSERT(statistics.hits == hits);
+}
+
+TEST_CASE(TestParseExpr_ExprTsysList)
+{
+	auto tsys = ITsysAlloc::Create();
+	ITsys* types[] =
+	{
+		tsys->Int(),
+		tsys->Size(),
+		tsys->Nullptr(),
+		tsys->Zero(),
+		tsys->Int()->PtrOf(),
+		tsys->Int()->LRefOf(),
+	};
+
+	ExprTsysList list;
+	for (vint i = 0; i < 6; i++)
+	{
+		list.Add({ nullptr,ExprTsysType::PRValue,types[i] });
+	}
+	TEST_ASSERT(list.Count() == 6);
+	for (vint i = 0; i < 6; i++)
+	{
+		TEST_ASSERT(list[i].tsys == types[i]);
+		TEST_ASSERT(list.Contains({ nullptr,ExprTsysType::PRValue,types[i] }));
+		TEST_ASSERT(!list.Contains({ nullptr,ExprTsysType::LValue,types[i] }));
+	}
+
+	list.RemoveAt(1);
+	list.RemoveAt(4);
+	TEST_ASSERT(list.Count() == 4);
+	TEST_ASSERT(list[0].tsys == types[0]);
+	TEST_ASSERT(list[1].tsys == types[2]);
+	TEST_ASSERT(list[2].tsys == types[3]);
+	TEST_ASSERT(list[3].tsys == types[4]);
+	TEST_ASSERT(!list.Contains({ nullptr,ExprTsysType::PRValue,types[1] }));
+	TEST_ASSERT(!list.Contains({ nullptr,ExprTsysType::PRValue,types[5] }));
+	TEST_ASSERT(list.Contains({ nullptr,ExprTsysType::PRValue,types[4] }));
+}
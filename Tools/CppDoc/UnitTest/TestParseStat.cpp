@@ -100,4 +100,26 @@ __except (0)
 	__finally
 		;
 )");
-}
\ No newline at end of file
+}
+
+TEST_CASE(TestParseStat_ReuseScope)
+{
+	auto input = LR"(
+void F()
+{
+	1;
+	if (0) 1;
+	{ 2; 3; }
+	int x = 0;
+	x;
+	x;
+}
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	const auto& scopes = pa.unit->root->children[L"$"];
+	TEST_ASSERT(scopes.Count() == 2);
+	TEST_ASSERT(scopes[0]->children[L"$"].Count() == 2);
+	TEST_ASSERT(scopes[0]->children[L"x"].Count() == 1);
+	TEST_ASSERT(scopes[1]->children.Count() == 0);
+}
@@ -113,14 +113,14 @@ namespace a::b
 	COMPILE_PROGRAM(program, pa, input);
 	{
 		SortedList<vint> accessed;
-		pa.recorder = CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
+		pa.unit->SetRecorder(CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
 		{
 			BEGIN_ASSERT_SYMBOL
 				ASSERT_SYMBOL(0, L"a", 0, 0, NamespaceDeclaration, 1, 10)
 				ASSERT_SYMBOL(1, L"b", 0, 3, NamespaceDeclaration, 1, 13)
 				ASSERT_SYMBOL(2, L"X", 0, 6, ForwardEnumDeclaration, 3, 6)
 			END_ASSERT_SYMBOL
-		});
+		}));
 		AssertType(
 			L"a::b::X",
 			L"a :: b :: X",
@@ -130,14 +130,14 @@ namespace a::b
 	}
 	{
 		SortedList<vint> accessed;
-		pa.recorder = CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
+		pa.unit->SetRecorder(CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
 		{
 			BEGIN_ASSERT_SYMBOL
 				ASSERT_SYMBOL(0, L"a", 0, 11, NamespaceDeclaration, 1, 10)
 				ASSERT_SYMBOL(1, L"b", 0, 14, NamespaceDeclaration, 1, 13)
 				ASSERT_SYMBOL(2, L"X", 0, 17, ForwardEnumDeclaration, 3, 6)
 			END_ASSERT_SYMBOL
-		});
+		}));
 		AssertType(
 			L"typename ::a::b::X::Y::Z",
 			L"__root :: a :: typename b :: typename X :: typename Y :: typename Z",
@@ -147,7 +147,7 @@ namespace a::b
 	}
 	{
 		SortedList<vint> accessed;
-		pa.recorder = CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
+		pa.unit->SetRecorder(CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
 		{
 			BEGIN_ASSERT_SYMBOL
 				ASSERT_SYMBOL(0, L"a", 0, 0, NamespaceDeclaration, 1, 10)
@@ -156,7 +156,7 @@ namespace a::b
 				ASSERT_SYMBOL(3, L"a", 0, 25, NamespaceDeclaration, 1, 10)
 				ASSERT_SYMBOL(4, L"b", 0, 28, NamespaceDeclaration, 1, 13)
 			END_ASSERT_SYMBOL
-		});
+		}));
 		AssertType(
 			L"a::b::X(__cdecl typename a::b::*)()",
 			L"a :: b :: X () __cdecl (a :: typename b ::) *",
@@ -189,7 +189,7 @@ namespace c::d
 	COMPILE_PROGRAM(program, pa, input);
 	{
 		SortedList<vint> accessed;
-		pa.recorder = CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
+		pa.unit->SetRecorder(CreateTestIndexRecorder([&](CppName& name, Ptr<Resolving> resolving)
 		{
 			BEGIN_ASSERT_SYMBOL
 				ASSERT_SYMBOL(0, L"c", 0, 0, NamespaceDeclaration, 8, 10)
@@ -198,7 +198,7 @@ namespace c::d
 				ASSERT_SYMBOL(3, L"Z", 0, 9, ClassDeclaration, 12, 9)
 				ASSERT_SYMBOL(4, L"Y", 0, 12, ForwardEnumDeclaration, 5, 7)
 			END_ASSERT_SYMBOL
-		});
+		}));
 		AssertType(
 			L"c::d::Y::Z::Y",
 			L"c :: d :: Y :: Z :: Y",
@@ -206,4 +206,38 @@ namespace c::d
 			pa);
 		TEST_ASSERT(accessed.Count() == 5);
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE(TestParseType_TsysCache)
+{
+	auto input = LR"(
+struct X;
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	CppTokenReader typeReader(GlobalCppLexer(), L"X*(*)(int, X&)");
+	auto typeCursor = typeReader.GetFirstToken();
+	auto type = ParseType(pa, typeCursor);
+	TEST_ASSERT(!typeCursor);
+
+	TypeTsysList types1, types2, types3;
+	TypeToTsys(pa, type, types1);
+	TypeToTsys(pa, type, types2);
+	TEST_ASSERT(type->tsysCache && type->tsysCache->entries.Count() == 1);
+	TEST_ASSERT(CompareEnumerable(types1, types2) == 0);
+
+	// any change to symbol tables invalidates cached results
+	pa.unit->root->CreateDeclSymbol(program->decls[0]);
+	TypeToTsys(pa, type, types3);
+	TEST_ASSERT(type->tsysCache->entries.Count() == 1);
+	TEST_ASSERT(type->tsysCache->entries[0]->generation == pa.unit->GetGeneration());
+	TEST_ASSERT(CompareEnumerable(types1, types3) == 0);
+
+	// types from another allocator are never reused
+	TypeTsysList types4;
+	auto previousTsys = pa.unit->tsys;
+	pa.unit->SetTsys(ITsysAlloc::Create());
+	TypeToTsys(pa, type, types4);
+	TEST_ASSERT(types4.Count() == 1);
+	TEST_ASSERT(types4[0] != types1[0]);
+}
@@ -0,0 +1,122 @@
+#include <Snapshot.h>
+#include <Index.h>
+#include "Util.h"
+
+TEST_CASE(TestSnapshot_ResumeAfterPrefix)
+{
+	WString prefix = LR"(
+namespace a
+{
+	struct X {};
+	void F(X);
+}
+a::X x;
+)";
+	auto tsys = ITsysAlloc::Create();
+	auto tint = tsys->Int();
+	PrefixSnapshot snapshot(GlobalCppLexer(), prefix, tsys);
+	auto root = snapshot.GetParsingArguments().unit->root.Obj();
+	auto ns = root->children[L"a"][0].Obj();
+	TEST_ASSERT(snapshot.GetProgram()->decls.Count() == 2);
+	TEST_ASSERT(root->children.Count() == 2);
+	TEST_ASSERT(ns->children.Count() == 2);
+	TEST_ASSERT(ns->decls.Count() == 1);
+
+	TEST_ASSERT(!snapshot.IsPrefixOf(L"struct Y {};"));
+
+	{
+		auto recorder = MakePtr<IndexRecorder>();
+		auto result = snapshot.Parse(prefix + L"namespace a { struct Y {}; void F(Y); } a::Y y; a::X z;", recorder);
+		TEST_ASSERT(result->program->decls.Count() == 3);
+		TEST_ASSERT(result->symbols.Count() == 4);
+		TEST_ASSERT(result->tsys->Int() == tint);
+		TEST_ASSERT(recorder->GetRecordCount() > 0);
+		for (vint i = 0; i < recorder->GetRecordCount(); i++)
+		{
+			TEST_ASSERT(recorder->GetRecord(i).offset >= prefix.Length());
+		}
+	}
+
+	TEST_ASSERT(root->children.Count() == 2);
+	TEST_ASSERT(ns->children.Count() == 2);
+	TEST_ASSERT(ns->children[L"F"].Count() == 1);
+	TEST_ASSERT(ns->decls.Count() == 1);
+
+	{
+		auto result = snapshot.Parse(prefix + L"a::X w;", nullptr);
+		TEST_ASSERT(result->program->decls.Count() == 1);
+	}
+
+	try
+	{
+		snapshot.Parse(prefix + L"a::Y w;", nullptr);
+		TEST_ASSERT(false);
+	}
+	catch (const StopParsingException&)
+	{
+	}
+	TEST_ASSERT(root->children.Count() == 2);
+}
+
+TEST_CASE(TestSnapshot_ChildrenFilter)
+{
+	WString prefix = LR"(
+namespace a { struct X {}; }
+)";
+	PrefixSnapshot snapshot(GlobalCppLexer(), prefix, ITsysAlloc::Create());
+	auto ns = snapshot.GetParsingArguments().unit->root->children[L"a"][0].Obj();
+	auto filter = ns->childrenFilter;
+
+	snapshot.Parse(prefix + L"namespace a { struct Y {}; } a::Y y;", nullptr);
+	TEST_ASSERT(ns->children.Count() == 1);
+	TEST_ASSERT(ns->childrenFilter == filter);
+	TEST_ASSERT(ns->MayContainChild(Symbol::GetNameFilter(L"X")));
+
+	// removed children are not found, remaining and newly added children are
+	try
+	{
+		snapshot.Parse(prefix + L"a::Y y;", nullptr);
+		TEST_ASSERT(false);
+	}
+	catch (const StopParsingException&)
+	{
+	}
+	snapshot.Parse(prefix + L"a::X x;", nullptr);
+	snapshot.Parse(prefix + L"namespace a { struct Z {}; } a::Z z;", nullptr);
+	TEST_ASSERT(ns->childrenFilter == filter);
+}
+
+TEST_CASE(TestSnapshot_RollbackCaches)
+{
+	WString prefix = LR"(
+namespace a { struct X {}; }
+namespace b {}
+namespace c { using namespace b; }
+struct A { void F(); };
+struct B : A { void G(); };
+)";
+	PrefixSnapshot snapshot(GlobalCppLexer(), prefix, ITsysAlloc::Create());
+	auto root = snapshot.GetParsingArguments().unit->root.Obj();
+	auto symbolB = root->children[L"B"][0].Obj();
+	auto symbolC = root->children[L"c"][0].Obj();
+	TEST_ASSERT(symbolB->classMemberCache);
+	auto memberCount = symbolB->classMemberCache->inheritedMembers.Count();
+
+	// a using directive added by an input is visible transitively in that input only
+	snapshot.Parse(prefix + L"namespace b { using namespace a; } c::X x;", nullptr);
+	TEST_ASSERT(symbolC->usingNssClosure.Count() == 1);
+	try
+	{
+		snapshot.Parse(prefix + L"c::X y;", nullptr);
+		TEST_ASSERT(false);
+	}
+	catch (const StopParsingException&)
+	{
+	}
+
+	// members of base classes found by an input are not kept
+	snapshot.Parse(prefix + L"void A::F() {} void B::G() { F(); }", nullptr);
+	TEST_ASSERT(symbolB->classMemberCache->inheritedMembers.Count() == memberCount);
+	TEST_ASSERT(root->children[L"A"][0]->children[L"F"].Count() == 1);
+	snapshot.Parse(prefix + L"void B::G() { F(); }", nullptr);
+}
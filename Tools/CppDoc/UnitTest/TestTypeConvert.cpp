@@ -83,7 +83,8 @@ struct RunTypeConvertFromTemp
 
 TEST_CASE(TestTypeConvert_Exact)
 {
-	ParsingArguments pa(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingUnit unit(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingArguments pa(&unit);
 #define S Exact
 	TEST_CONV_TYPE(int,						int,									S,	S);
 	TEST_CONV_TYPE(int,						const int,								S,	S);
@@ -111,7 +112,8 @@ TEST_CASE(TestTypeConvert_Exact)
 
 TEST_CASE(TestTypeConvert_TrivalConversion)
 {
-	ParsingArguments pa(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingUnit unit(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingArguments pa(&unit);
 #define S TrivalConversion
 #define F Illegal
 	TEST_CONV_TYPE(int*,					const int*,								S,	S);
@@ -216,7 +218,8 @@ enum class C{};
 
 TEST_CASE(TestTypeConvert_StandardConversion)
 {
-	ParsingArguments pa(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingUnit unit(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingArguments pa(&unit);
 #define S StandardConversion
 #define F Illegal
 	TEST_CONV_TYPE(signed int,				unsigned int,							S,	S);
@@ -244,7 +247,8 @@ TEST_CASE(TestTypeConvert_StandardConversion)
 
 TEST_CASE(TestTypeConvert_Illegal)
 {
-	ParsingArguments pa(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingUnit unit(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingArguments pa(&unit);
 #define F Illegal
 	TEST_CONV_TYPE(const int&,				int&,									F,	F);
 	TEST_CONV_TYPE(volatile int&,			int&,									F,	F);
@@ -625,4 +629,42 @@ struct Source
 
 #undef TEST_CONV_TYPE
 
+TEST_CASE(TestTypeConvert_Cache)
+{
+	auto input = LR"(
+struct Source
+{
+};
+
+struct Target
+{
+	Target(const Source&);
+};
+
+struct Forward;
+)";
+	COMPILE_PROGRAM(program, pa, input);
+
+	auto stat1 = pa.unit->tsys->GetConvCacheStatistics();
+	AssertTypeConvert(pa, L"Source", L"const Target&", TsysConv::UserDefinedConversion, false);
+	auto stat2 = pa.unit->tsys->GetConvCacheStatistics();
+	AssertTypeConvert(pa, L"Source", L"const Target&", TsysConv::UserDefinedConversion, false);
+	auto stat3 = pa.unit->tsys->GetConvCacheStatistics();
+
+	TEST_ASSERT(stat2.misses == stat1.misses + 1);
+	TEST_ASSERT(stat2.hits == stat1.hits);
+	TEST_ASSERT(stat3.misses == stat2.misses);
+	TEST_ASSERT(stat3.hits == stat2.hits + 1);
+
+	// a class that is only forward declared could be defined later
+	AssertTypeConvert(pa, L"Forward*", L"Source*", TsysConv::Illegal, false);
+	auto stat4 = pa.unit->tsys->GetConvCacheStatistics();
+	AssertTypeConvert(pa, L"Forward*", L"Source*", TsysConv::Illegal, false);
+	auto stat5 = pa.unit->tsys->GetConvCacheStatistics();
+
+	TEST_ASSERT(stat4.misses == stat3.misses + 1);
+	TEST_ASSERT(stat5.misses == stat4.misses + 1);
+	TEST_ASSERT(stat5.hits == stat3.hits);
+}
+
 #pragma warning (push)
\ No newline at end of file
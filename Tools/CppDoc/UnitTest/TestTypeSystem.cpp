@@ -96,6 +96,88 @@ TEST_CASE(TestTypeSystem_Array)
 	TEST_ASSERT(tvoid->ArrayOf(1) != tvoid->ArrayOf(2));
 }
 
+TEST_CASE(TestTypeSystem_Interned)
+{
+	auto tsys = ITsysAlloc::Create();
+	auto tvoid = tsys->PrimitiveOf({ TsysPrimitiveType::Void,TsysBytes::_1 });
+
+	List<ITsys*> arrays;
+	for (vint i = 1; i <= 1000; i++)
+	{
+		arrays.Add(tvoid->ArrayOf(i));
+	}
+	for (vint i = 1; i <= 1000; i++)
+	{
+		TEST_ASSERT(tvoid->ArrayOf(i) == arrays[i - 1]);
+		TEST_ASSERT(arrays[i - 1]->GetParamCount() == i);
+		TEST_ASSERT(arrays[i - 1]->MemberOf(tvoid) == arrays[i - 1]->MemberOf(tvoid));
+	}
+}
+
+TEST_CASE(TestTypeSystem_Id)
+{
+	auto tsys = ITsysAlloc::Create();
+	auto tvoid = tsys->PrimitiveOf({ TsysPrimitiveType::Void,TsysBytes::_1 });
+	auto tptr = tvoid->PtrOf();
+	auto tarray = tptr->ArrayOf(1);
+
+	TEST_ASSERT(tsys->Zero()->GetId() == 0);
+	TEST_ASSERT(tsys->Nullptr()->GetId() == 1);
+	TEST_ASSERT(tvoid->GetId() == 2);
+	TEST_ASSERT(tptr->GetId() == 3);
+	TEST_ASSERT(tarray->GetId() == 4);
+	TEST_ASSERT(tsys->GetTsysCount() == 5);
+
+	for (vint i = 0; i < tsys->GetTsysCount(); i++)
+	{
+		TEST_ASSERT(tsys->GetTsysById(i)->GetId() == i);
+	}
+}
+
+TEST_CASE(TestTypeSystem_AllocatorPerThread)
+{
+	const vint ThreadCount = 8;
+	const vint TypeCount = 2000;
+	List<vint> results[ThreadCount];
+
+	auto buildTypes = [&](List<vint>& ids)
+	{
+		auto tsys = ITsysAlloc::Create();
+		for (vint i = 0; i < TypeCount; i++)
+		{
+			auto primitive = tsys->PrimitiveOf({ (TsysPrimitiveType)(i % (vint)TsysPrimitiveType::_COUNT),(TsysBytes)(i % (vint)TsysBytes::_COUNT) });
+			auto array = primitive->ArrayOf(i % 100 + 1);
+			auto cv = array->PtrOf()->CVOf({ true,(i % 2) == 1 });
+
+			List<ITsys*> params;
+			params.Add(cv);
+			params.Add(primitive->LRefOf());
+			auto func = primitive->FunctionOf(params, {});
+
+			ids.Add(cv->GetId());
+			ids.Add(func->MemberOf(primitive)->RRefOf()->GetId());
+			ids.Add(func->GenericOf(params)->GetId());
+		}
+	};
+
+	// allocators are not shared, every thread owns one and building the same types in the same order must give the same ids
+	List<Thread*> threads;
+	for (vint i = 0; i < ThreadCount; i++)
+	{
+		threads.Add(Thread::CreateAndStart([&, i]() { buildTypes(results[i]); }, false));
+	}
+	for (vint i = 0; i < ThreadCount; i++)
+	{
+		threads[i]->Wait();
+		delete threads[i];
+	}
+
+	for (vint i = 1; i < ThreadCount; i++)
+	{
+		TEST_ASSERT(CompareEnumerable(results[0], results[i]) == 0);
+	}
+}
+
 TEST_CASE(TestTypeSystem_CV)
 {
 	auto tsys = ITsysAlloc::Create();
@@ -198,4 +280,238 @@ TEST_CASE(TestTypeSystem_Type)
 	types.Add(tgarg);
 	TEST_ASSERT(tvoid->FunctionOf(types, {})->GetType() == TsysType::Function);
 	TEST_ASSERT(tvoid->GenericOf(types)->GetType() == TsysType::Generic);
-}
\ No newline at end of file
+}
+
+ITsys* GetEntityByWalking(ITsys* type, TsysCV& cv, TsysRefType& refType)
+{
+	cv = { false,false };
+	refType = TsysRefType::None;
+	while (true)
+	{
+		switch (type->GetType())
+		{
+		case TsysType::LRef:
+			refType = TsysRefType::LRef;
+			break;
+		case TsysType::RRef:
+			refType = TsysRefType::RRef;
+			break;
+		case TsysType::CV:
+			cv = type->GetCV();
+			break;
+		default:
+			return type;
+		}
+		type = type->GetElement();
+	}
+}
+
+TEST_CASE(TestTypeSystem_Entity)
+{
+	auto n = MakePtr<Symbol>();
+	auto tsys = ITsysAlloc::Create();
+	auto tint = tsys->Int();
+
+	List<ITsys*> types;
+	types.Add(tint);
+	types.Add(tsys->DeclOf(n.Obj()));
+	types.Add(tint->PtrOf());
+	types.Add(tint->ArrayOf(2));
+	types.Add(tint->CVOf({ true,false })->PtrOf());
+
+	// precomputed entities must be the same as walking through references and CV
+	for (vint i = 0; i < types.Count(); i++)
+	{
+		List<ITsys*> wrapped;
+		for (vint j = 0; j < 4; j++)
+		{
+			auto cvType = types[i]->CVOf({ (j & 2) != 0,(j & 1) != 0 });
+			wrapped.Add(cvType);
+			wrapped.Add(cvType->LRefOf());
+			wrapped.Add(cvType->RRefOf());
+			wrapped.Add(cvType->RRefOf()->LRefOf());
+		}
+
+		for (vint j = 0; j < wrapped.Count(); j++)
+		{
+			TsysCV cv1, cv2;
+			TsysRefType ref1, ref2;
+			auto entity1 = wrapped[j]->GetEntity(cv1, ref1);
+			auto entity2 = GetEntityByWalking(wrapped[j], cv2, ref2);
+			TEST_ASSERT(entity1 == types[i]);
+			TEST_ASSERT(entity1 == entity2);
+			TEST_ASSERT(cv1.isGeneralConst == cv2.isGeneralConst);
+			TEST_ASSERT(cv1.isVolatile == cv2.isVolatile);
+			TEST_ASSERT(ref1 == ref2);
+		}
+	}
+}
+
+TEST_CASE(TestTypeSystem_Overlay)
+{
+	auto n = MakePtr<Symbol>();
+	auto m = MakePtr<Symbol>();
+	auto base = ITsysAlloc::Create();
+	auto tint = base->Int();
+	auto tdecl = base->DeclOf(n.Obj());
+
+	bool failed = false;
+	try
+	{
+		ITsysAlloc::CreateOverlay(base);
+	}
+	catch (const Error&)
+	{
+		failed = true;
+	}
+	TEST_ASSERT(failed);
+
+	base->Freeze();
+	auto overlay1 = ITsysAlloc::CreateOverlay(base);
+	auto overlay2 = ITsysAlloc::CreateOverlay(base);
+	TEST_ASSERT(overlay1->Zero() == base->Zero());
+	TEST_ASSERT(overlay1->Int() == tint);
+	TEST_ASSERT(overlay1->DeclOf(n.Obj()) == tdecl);
+	TEST_ASSERT(overlay1->GetTsysById(tint->GetId()) == tint);
+
+	auto tlocal1 = overlay1->DeclOf(m.Obj());
+	auto tlocal2 = overlay2->DeclOf(m.Obj());
+	TEST_ASSERT(tlocal1 == overlay1->DeclOf(m.Obj()));
+	TEST_ASSERT(tlocal1 != tlocal2);
+	TEST_ASSERT(tlocal1->GetId() != tint->GetId());
+	TEST_ASSERT(overlay1->GetTsysById(tlocal1->GetId()) == tlocal1);
+
+	List<ITsys*> params;
+	params.Add(tint);
+	{
+		TsysOverlayScope scope(overlay1);
+		auto tfunc = tint->FunctionOf(params, {});
+		TEST_ASSERT(tfunc == tint->FunctionOf(params, {}));
+		TEST_ASSERT(overlay1->GetTsysById(tfunc->GetId()) == tfunc);
+	}
+
+	params.Add(tlocal1);
+	auto tlocalFunc = tint->FunctionOf(params, {});
+	TEST_ASSERT(tlocalFunc == tint->FunctionOf(params, {}));
+	TEST_ASSERT(overlay1->GetTsysById(tlocalFunc->GetId()) == tlocalFunc);
+	TEST_ASSERT(tint->MemberOf(tlocal1) == tint->MemberOf(tlocal1));
+	TEST_ASSERT(overlay1->GetTsysById(tint->MemberOf(tlocal1)->GetId()) == tint->MemberOf(tlocal1));
+
+	try
+	{
+		base->DeclOf(m.Obj());
+		TEST_ASSERT(false);
+	}
+	catch (const Error&)
+	{
+	}
+}
+
+TEST_CASE(TestTypeSystem_OverlayReadOnly)
+{
+	auto n = MakePtr<Symbol>();
+	auto base = ITsysAlloc::Create();
+	auto tint = base->Int();
+	auto tdecl = base->DeclOf(n.Obj());
+	auto tconst = tint->CVOf({ true,false });
+	auto baseCount = base->GetTsysCount();
+
+	base->Freeze();
+	auto overlay1 = ITsysAlloc::CreateOverlay(base);
+	auto overlay2 = ITsysAlloc::CreateOverlay(base);
+	auto build = [&](Ptr<ITsysAlloc> overlay)
+	{
+		TsysOverlayScope scope(overlay);
+		List<ITsys*> params;
+		params.Add(tint->LRefOf());
+		params.Add(tdecl->CVOf({ true,false })->PtrOf());
+		auto treturn = overlay->PrimitiveOf({ TsysPrimitiveType::Float,TsysBytes::_8 })->RRefOf();
+		return treturn->FunctionOf(params, {})->MemberOf(tdecl)->ArrayOf(2)->PtrOf();
+	};
+
+	// both overlays build the same composite type without touching the base
+	auto t1 = build(overlay1);
+	auto t2 = build(overlay2);
+	TEST_ASSERT(t1 == build(overlay1));
+	TEST_ASSERT(t2 == build(overlay2));
+	TEST_ASSERT(t1 != t2);
+	TEST_ASSERT(overlay1->GetTsysById(t1->GetId()) == t1);
+	TEST_ASSERT(overlay2->GetTsysById(t2->GetId()) == t2);
+	TEST_ASSERT(base->GetTsysCount() == baseCount);
+
+	// types created before the base is frozen are still shared
+	TEST_ASSERT(tint->CVOf({ true,false }) == tconst);
+	TEST_ASSERT(overlay1->Int() == tint);
+
+	// without an activated overlay the base cannot create new types
+	bool failed = false;
+	try
+	{
+		tint->PtrOf();
+	}
+	catch (const Error&)
+	{
+		failed = true;
+	}
+	TEST_ASSERT(failed);
+}
+
+TEST_CASE(TestTypeSystem_OverlayThreads)
+{
+	const vint ThreadCount = 4;
+	const vint TypeCount = 1000;
+	auto n = MakePtr<Symbol>();
+	auto base = ITsysAlloc::Create();
+	auto tdecl = base->DeclOf(n.Obj());
+	List<ITsys*> primitives;
+	for (vint i = 0; i < (vint)TsysPrimitiveType::_COUNT; i++)
+	{
+		primitives.Add(base->PrimitiveOf({ (TsysPrimitiveType)i,TsysBytes::_4 }));
+	}
+	base->Freeze();
+	auto baseCount = base->GetTsysCount();
+
+	Ptr<ITsysAlloc> overlays[ThreadCount];
+	List<vint> results[ThreadCount];
+	for (vint i = 0; i < ThreadCount; i++)
+	{
+		overlays[i] = ITsysAlloc::CreateOverlay(base);
+	}
+
+	auto buildTypes = [&](Ptr<ITsysAlloc> overlay, List<vint>& ids)
+	{
+		TsysOverlayScope scope(overlay);
+		for (vint i = 0; i < TypeCount; i++)
+		{
+			auto primitive = primitives[i % primitives.Count()];
+			auto cv = primitive->ArrayOf(i % 10 + 1)->PtrOf()->CVOf({ true,(i % 2) == 1 });
+
+			List<ITsys*> params;
+			params.Add(cv);
+			params.Add(tdecl->LRefOf());
+			auto func = primitive->FunctionOf(params, {});
+
+			ids.Add(cv->GetId());
+			ids.Add(func->MemberOf(tdecl)->RRefOf()->GetId());
+			ids.Add(func->GenericOf(params)->GetId());
+		}
+	};
+
+	// threads build overlapping types over one frozen base, each in its own overlay
+	List<Thread*> threads;
+	for (vint i = 0; i < ThreadCount; i++)
+	{
+		threads.Add(Thread::CreateAndStart([&, i]() { buildTypes(overlays[i], results[i]); }, false));
+	}
+	for (vint i = 0; i < ThreadCount; i++)
+	{
+		threads[i]->Wait();
+		delete threads[i];
+	}
+
+	for (vint i = 1; i < ThreadCount; i++)
+	{
+		TEST_ASSERT(CompareEnumerable(results[0], results[i]) == 0);
+	}
+	TEST_ASSERT(base->GetTsysCount() == baseCount);
+}
@@ -27,7 +27,8 @@ extern void					AssertProgram(Ptr<Program> program, const WString& log);
 #define COMPILE_PROGRAM_WITH_RECORDER(PROGRAM, PA, INPUT, RECORDER)\
 	CppTokenReader reader(GlobalCppLexer(), INPUT);\
 	auto cursor = reader.GetFirstToken();\
-	ParsingArguments PA(new Symbol, ITsysAlloc::Create(), RECORDER);\
+	ParsingUnit PA##Unit(new Symbol, ITsysAlloc::Create(), RECORDER);\
+	ParsingArguments PA(&PA##Unit);\
 	auto PROGRAM = ParseProgram(PA, cursor);\
 	TEST_ASSERT(!cursor)\
 
@@ -45,12 +46,12 @@ public:
 	{
 	}
 
-	void Index(CppName& name, Ptr<Resolving> resolving)
+	void Index(CppName& name, const Ptr<Resolving>& resolving)
 	{
 		callback(name, resolving);
 	}
 
-	void ExpectValueButType(CppName& name, Ptr<Resolving> resolving)
+	void ExpectValueButType(CppName& name, const Ptr<Resolving>& resolving)
 	{
 		TEST_ASSERT(false);
 	}
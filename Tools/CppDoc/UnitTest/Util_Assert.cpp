@@ -26,7 +26,8 @@ AssertType
 
 void AssertType(const WString& input, const WString& log, const WString& logTsys)
 {
-	ParsingArguments pa(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingUnit unit(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingArguments pa(&unit);
 	AssertType(input, log, logTsys, pa);
 }
 
@@ -74,7 +75,8 @@ AssertExpr
 
 void AssertExpr(const WString& input, const WString& log, const WString& logTsys)
 {
-	ParsingArguments pa(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingUnit unit(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingArguments pa(&unit);
 	AssertExpr(input, log, logTsys, pa);
 }
 
@@ -136,7 +138,8 @@ AssertStat
 
 void AssertStat(const WString& input, const WString& log)
 {
-	ParsingArguments pa(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingUnit unit(new Symbol, ITsysAlloc::Create(), nullptr);
+	ParsingArguments pa(&unit);
 	AssertStat(input, log, pa);
 }
 